@@ -0,0 +1,16 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in float fragHealth;
+
+// Output fragment color
+out vec4 finalColor;
+
+uniform vec4 healthColor;
+uniform vec4 missingColor;
+
+void main()
+{
+    finalColor = fragTexCoord.x <= fragHealth ? healthColor : missingColor;
+}
@@ -0,0 +1,29 @@
+#version 330
+
+// Input instance attributes, xyz is the center of the bar and w how much health is left, from 0 to 1
+in vec4 instanceBar;
+
+// Input uniform values
+uniform mat4 viewProjection;
+uniform vec3 cameraRight;
+uniform vec3 cameraUp;
+uniform vec2 size;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out float fragHealth;
+
+// two triangles covering the bar, there's no vertex buffer
+const vec2 corners[6] = vec2[6](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+    vec2 corner = corners[gl_VertexID];
+
+    fragTexCoord = corner;
+    fragHealth = instanceBar.w;
+
+    vec3 position = instanceBar.xyz + cameraRight*(corner.x - 0.5)*size.x + cameraUp*(corner.y - 0.5)*size.y;
+    gl_Position = viewProjection*vec4(position, 1.0);
+}
@@ -6,11 +6,13 @@ layout (location = 2) in vec4 color;
 
 uniform mat4 mvp;
 uniform vec3 offset = vec3(0,0,0);
+// batched draws are instanced once per arena tile, every instance gets moved by its own offset
+uniform vec3 offsets[4];
 
 out vec4 fragColor;
 
 void main() {
-    gl_Position = mvp * vec4(pos + offset, 1.0);
+    gl_Position = mvp * vec4(pos + offset + offsets[gl_InstanceID], 1.0);
     gl_PointSize = size;
     fragColor = color;
 }
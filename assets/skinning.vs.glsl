@@ -1,7 +1,5 @@
 #version 330
 
-#define MAX_BONE_NUM 128
-
 // Input vertex attributes
 in vec3 vertexPosition;
 in vec2 vertexTexCoord;
@@ -10,39 +8,58 @@ in vec3 vertexNormal;
 in vec4 vertexBoneIds;
 in vec4 vertexBoneWeights;
 
+// Input instance attributes, one set per drawn enemy
+in mat4 instanceTransform;
+in vec4 instanceTint;
+in float instancePaletteRow;
+
 // Input uniform values
-uniform mat4 mvp;
-uniform mat4 matNormal;
-uniform mat4 boneMatrices[MAX_BONE_NUM];
+uniform mat4 viewProjection;
+// every row is one pose, every bone is 4 texels holding the columns of its matrix
+uniform sampler2D bonePalette;
+// where the bones of the current mesh start in a row
+uniform int boneOffset;
 
 // Output vertex attributes (to fragment shader)
 out vec2 fragTexCoord;
 out vec4 fragColor;
 out vec3 fragNormal;
 
+mat4 bone(int index) {
+    int row = int(instancePaletteRow);
+    int x = 4*(boneOffset + index);
+
+    return mat4(
+        texelFetch(bonePalette, ivec2(x, row), 0),
+        texelFetch(bonePalette, ivec2(x + 1, row), 0),
+        texelFetch(bonePalette, ivec2(x + 2, row), 0),
+        texelFetch(bonePalette, ivec2(x + 3, row), 0));
+}
+
 void main() {
-    int boneIndex0 = int(vertexBoneIds.x);
-    int boneIndex1 = int(vertexBoneIds.y);
-    int boneIndex2 = int(vertexBoneIds.z);
-    int boneIndex3 = int(vertexBoneIds.w);
+    mat4 bone0 = bone(int(vertexBoneIds.x));
+    mat4 bone1 = bone(int(vertexBoneIds.y));
+    mat4 bone2 = bone(int(vertexBoneIds.z));
+    mat4 bone3 = bone(int(vertexBoneIds.w));
 
     vec4 skinnedPosition =
-        vertexBoneWeights.x*(boneMatrices[boneIndex0]*vec4(vertexPosition, 1.0)) +
-        vertexBoneWeights.y*(boneMatrices[boneIndex1]*vec4(vertexPosition, 1.0)) + 
-        vertexBoneWeights.z*(boneMatrices[boneIndex2]*vec4(vertexPosition, 1.0)) + 
-        vertexBoneWeights.w*(boneMatrices[boneIndex3]*vec4(vertexPosition, 1.0));
+        vertexBoneWeights.x*(bone0*vec4(vertexPosition, 1.0)) +
+        vertexBoneWeights.y*(bone1*vec4(vertexPosition, 1.0)) +
+        vertexBoneWeights.z*(bone2*vec4(vertexPosition, 1.0)) +
+        vertexBoneWeights.w*(bone3*vec4(vertexPosition, 1.0));
 
     vec4 skinnedNormal =
-        vertexBoneWeights.x*(boneMatrices[boneIndex0]*vec4(vertexNormal, 0.0)) +
-        vertexBoneWeights.y*(boneMatrices[boneIndex1]*vec4(vertexNormal, 0.0)) + 
-        vertexBoneWeights.z*(boneMatrices[boneIndex2]*vec4(vertexNormal, 0.0)) + 
-        vertexBoneWeights.w*(boneMatrices[boneIndex3]*vec4(vertexNormal, 0.0));
+        vertexBoneWeights.x*(bone0*vec4(vertexNormal, 0.0)) +
+        vertexBoneWeights.y*(bone1*vec4(vertexNormal, 0.0)) +
+        vertexBoneWeights.z*(bone2*vec4(vertexNormal, 0.0)) +
+        vertexBoneWeights.w*(bone3*vec4(vertexNormal, 0.0));
     skinnedNormal.w = 0.0;
 
     fragTexCoord = vertexTexCoord;
-    fragColor = vertexColor;
+    fragColor = vertexColor*instanceTint;
 
-    fragNormal = normalize(vec3(matNormal*skinnedNormal));
+    // enemies are only ever scaled uniformly, so the model matrix works for normals too
+    fragNormal = normalize(mat3(instanceTransform)*skinnedNormal.xyz);
 
-    gl_Position = mvp*skinnedPosition;
+    gl_Position = viewProjection*instanceTransform*skinnedPosition;
 }
@@ -0,0 +1,94 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "enemies_spawner.hpp"
+#include "hitbox.hpp"
+#include "item_drops.hpp"
+#include "jobs.hpp"
+#include "raylib.h"
+#include "spell.hpp"
+#include "spell_caster.hpp"
+#include "utility.hpp"
+#include <format>
+#include <random>
+
+namespace {
+    // what `Arena::update` does every tick, minus input, the player and the ui
+    struct Sim {
+        static constexpr std::size_t cast_every = 10;
+
+        Enemies enemies;
+        ItemDrops item_drops;
+        caster::Caster caster;
+        SpellBook spellbook;
+
+        shapes::Circle player = shapes::Circle(Vector2Zero(), 10.0f);
+        std::size_t ticks = 0;
+
+        Sim(uint32_t max_cap, std::size_t spell_count) : enemies(max_cap), spellbook(spell_count) {
+            // same spells and spawns every run
+            rng::seed(42);
+            for (std::size_t i = 0; i < spell_count; i++) {
+                spellbook.emplace_back(Spell::random(10));
+            }
+        }
+
+        void tick() {
+            if (ticks++ % cast_every == 0) {
+                auto spell_id = ticks / cast_every % spellbook.size();
+                auto mouse = player.center + Vector2{100.0f, 50.0f};
+                caster.cast(spell_id, spellbook[spell_id], player.center, mouse, enemies);
+            }
+
+            enemies.tick(player);
+            enemies.take_exp();
+            enemies.take_souls();
+            caster.tick(spellbook, enemies, item_drops);
+            item_drops.pickup(player, [](auto&&) {});
+        }
+    };
+}
+
+TEST_CASE("Arena tick", "[arena][raylib][!benchmark]") {
+    InitWindow(100, 100, "BENCH");
+
+    {
+        // let the spawner fill the arena up before measuring
+        Sim sim(500, 10);
+        for (std::size_t i = 0; i < TICKS * 60; i++) {
+            sim.tick();
+        }
+
+        BENCHMARK(std::format("{} enemies", sim.enemies.enemies.size())) {
+            sim.tick();
+            return sim.enemies.enemies.size();
+        };
+    }
+
+    CloseWindow();
+}
+
+TEST_CASE("Enemy tick", "[arena][raylib][!benchmark]") {
+    InitWindow(100, 100, "BENCH");
+
+    {
+        shapes::Circle player(Vector2Zero(), 10.0f);
+
+        for (auto n : {1000uz, 5000uz}) {
+            // straight into the pool, the spawner would take ages to get here
+            EnemyPool pool(arena::arena_rec, true);
+            std::mt19937 gen(42);
+            std::uniform_real_distribution<float> x(arena::arena_rec.x, arena::arena_rec.x + ARENA_WIDTH);
+            std::uniform_real_distribution<float> y(arena::arena_rec.y, arena::arena_rec.y + ARENA_HEIGHT);
+            for (std::size_t i = 0; i < n; i++) {
+                pool.insert(Vector2{x(gen), y(gen)}, 1, false, enemies::Paladin{});
+            }
+
+            BENCHMARK(std::format("{} enemies, {} threads", n, jobs::pool().thread_count())) {
+                return pool.tick(player);
+            };
+        }
+    }
+
+    CloseWindow();
+}
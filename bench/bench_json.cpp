@@ -0,0 +1,58 @@
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+
+#include <format>
+#include <string>
+#include <string_view>
+
+// catch's own json reporter leaves benchmarks out, this one only has them
+// one object per benchmark, every duration in nanoseconds, meant to be kept around and diffed between commits
+//
+// usage: bench --reporter bench-json::out=bench.json --reporter console
+class BenchJsonReporter : public Catch::StreamingReporterBase {
+  public:
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string getDescription() {
+        return "Benchmark results as JSON";
+    }
+
+    void testRunStarting(const Catch::TestRunInfo& info) override {
+        StreamingReporterBase::testRunStarting(info);
+
+        m_stream << "{\n  \"version\": 1,\n  \"benchmarks\": [";
+    }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override {
+        m_stream << std::format(
+            "{}\n    {{\"test_case\": \"{}\", \"name\": \"{}\", \"samples\": {}, \"iterations\": {}, "
+            "\"mean\": {:.3f}, \"mean_lower\": {:.3f}, \"mean_upper\": {:.3f}, \"std_dev\": {:.3f}, "
+            "\"outlier_variance\": {:.4f}}}",
+            first ? "" : ",", escape(currentTestCaseInfo->name), escape(stats.info.name), stats.samples.size(),
+            stats.info.iterations, stats.mean.point.count(), stats.mean.lower_bound.count(),
+            stats.mean.upper_bound.count(), stats.standardDeviation.point.count(), stats.outlierVariance);
+        first = false;
+    }
+
+    void testRunEnded(const Catch::TestRunStats& stats) override {
+        m_stream << "\n  ]\n}\n";
+
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+  private:
+    bool first = true;
+
+    static std::string escape(std::string_view str) {
+        std::string escaped;
+        for (auto c : str) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+
+        return escaped;
+    }
+};
+
+CATCH_REGISTER_REPORTER("bench-json", BenchJsonReporter)
@@ -0,0 +1,80 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "grid.hpp"
+#include "hitbox.hpp"
+#include "quadtree.hpp"
+#include "utility.hpp"
+#include <format>
+#include <random>
+
+// position + movement
+using Boid = quadtree::pos<Vector2>;
+
+namespace {
+    template <typename Index> void fill(Index& index, std::size_t n) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> x(arena::arena_rec.x, arena::arena_rec.x + ARENA_WIDTH);
+        std::uniform_real_distribution<float> y(arena::arena_rec.y, arena::arena_rec.y + ARENA_HEIGHT);
+
+        for (std::size_t i = 0; i < n; i++) {
+            index.insert(Vector2{x(gen), y(gen)}, Vector2Zero());
+        }
+        index.maintain();
+    }
+
+    // one tick of `EnemyPool::update_target` + movement for everything in `index`, minus the enemy specific parts
+    template <typename Index> void flock(Index& index, const Vector2& target) {
+        static constexpr float neighbourhood_radius = 100.0f;
+        static constexpr float speed = 2.5f;
+
+        for (std::size_t i = 0; i < index.data->size(); i++) {
+            auto pos = index.data.vec[i].position();
+            shapes::Circle circle(pos, neighbourhood_radius);
+
+            Vector2 attraction = Vector2Subtract(target, pos);
+            attraction.x = wrap(attraction.x + ARENA_WIDTH / 2.0f, ARENA_WIDTH) - ARENA_WIDTH / 2.0f;
+            attraction.y = wrap(attraction.y + ARENA_HEIGHT / 2.0f, ARENA_HEIGHT) - ARENA_HEIGHT / 2.0f;
+            attraction = Vector2Normalize(attraction);
+
+            Vector2 separation = Vector2Zero();
+            index.query(
+                bounding_box(circle), [&circle](const Boid& b) { return check_collision(circle, b.position()); },
+                [&](const Boid& b, std::size_t ix) {
+                    if (ix == i) return;
+
+                    auto d = Vector2Subtract(pos, b.position());
+                    separation = Vector2Add(
+                        separation, Vector2Scale(Vector2Normalize(d), 1.0f / std::max(Vector2Length(d), 1e-6f)));
+                });
+
+            auto movement = Vector2Normalize(Vector2Add(Vector2Scale(attraction, 3.0f), Vector2Scale(separation, 5.0f)));
+            *index.data.vec[i] = movement;
+            pos = Vector2Add(pos, Vector2Scale(movement, speed));
+            arena::loop_around(pos.x, pos.y);
+            index.data.vec[i].set_position(pos);
+            index.update(i);
+        }
+
+        index.maintain();
+    }
+}
+
+TEST_CASE("Broadphase flocking", "[broadphase][!benchmark]") {
+    std::size_t n = GENERATE(1000, 5000, 10000);
+
+    quadtree::QuadTree<10, Boid> qt(arena::arena_rec, true);
+    fill(qt, n);
+    BENCHMARK(std::format("quadtree n={}", n)) {
+        flock(qt, Vector2Zero());
+        return qt.data->size();
+    };
+
+    grid::Grid<Boid> grid(arena::arena_rec, true);
+    fill(grid, n);
+    BENCHMARK(std::format("grid n={}", n)) {
+        flock(grid, Vector2Zero());
+        return grid.data->size();
+    };
+}
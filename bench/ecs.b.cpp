@@ -0,0 +1,108 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "ecs.hpp"
+#include "multiarray.hpp"
+#include "raylib.h"
+#include <cstdint>
+#include <format>
+#include <random>
+#include <vector>
+
+namespace {
+    using Mover = ecs::Archetype<Vector2, float>;
+    using World = ecs::build<Mover>;
+
+    // positions and speeds, nothing left dirty
+    std::vector<ecs::Entity> fill(World& world, std::size_t n) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> coord(-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> speed(0.5f, 2.5f);
+
+        std::vector<ecs::Entity> entities;
+        for (std::size_t i = 0; i < n; i++) {
+            entities.emplace_back(world.static_emplace_entity<Mover>(Vector2{coord(gen), coord(gen)}, speed(gen)));
+        }
+
+        // inserting marks everything dirty
+        world.make_system<Vector2, float>().run<ecs::OnlyDirty>([](Vector2&, float&) {});
+
+        return entities;
+    }
+}
+
+TEST_CASE("ecs::System::run", "[ecs][!benchmark]") {
+    std::size_t n = GENERATE(1000, 10000, 100000);
+    World world;
+    auto entities = fill(world, n);
+
+    BENCHMARK(std::format("every entity n={}", n)) {
+        float acc = 0.0f;
+        world.make_system<Vector2, const float>().run([&](Vector2& pos, const float& speed) {
+            pos.x += speed;
+            acc += pos.x;
+        });
+
+        return acc;
+    };
+}
+
+TEST_CASE("ecs::System::run OnlyDirty", "[ecs][!benchmark]") {
+    std::size_t n = GENERATE(1000, 10000, 100000);
+    std::size_t dirty_percent = GENERATE(1, 10, 100);
+    World world;
+    auto entities = fill(world, n);
+
+    // the dirty bits are kept, so every run sees the same entities
+    for (std::size_t i = 0; i < n; i += 100 / dirty_percent) {
+        world.mark_dirty<Vector2>(entities[i]);
+    }
+
+    BENCHMARK(std::format("OnlyDirty n={} dirty={}%", n, dirty_percent)) {
+        float acc = 0.0f;
+        world.make_system<Vector2, const float>().run<ecs::OnlyDirty | ecs::KeepDirty>(
+            [&](Vector2& pos, const float& speed) {
+                pos.x += speed;
+                acc += pos.x;
+            });
+
+        return acc;
+    };
+}
+
+TEST_CASE("multi_vector growth", "[ecs][!benchmark]") {
+    std::size_t n = GENERATE(1000, 100000);
+
+    BENCHMARK(std::format("emplace_back n={}", n)) {
+        multi_vector<uint32_t, float, Vector2> mv;
+        for (std::size_t i = 0; i < n; i++) {
+            mv.emplace_back(static_cast<uint32_t>(i), static_cast<float>(i), Vector2{1.0f, 2.0f});
+        }
+
+        return mv.size();
+    };
+
+    BENCHMARK(std::format("reserved n={}", n)) {
+        multi_vector<uint32_t, float, Vector2> mv(n);
+        for (std::size_t i = 0; i < n; i++) {
+            mv.emplace_back(static_cast<uint32_t>(i), static_cast<float>(i), Vector2{1.0f, 2.0f});
+        }
+
+        return mv.size();
+    };
+
+    // the same columns as one std::vector per type, to compare against
+    BENCHMARK(std::format("std::vector n={}", n)) {
+        std::vector<uint32_t> ids;
+        std::vector<float> values;
+        std::vector<Vector2> vecs;
+        for (std::size_t i = 0; i < n; i++) {
+            ids.emplace_back(static_cast<uint32_t>(i));
+            values.emplace_back(static_cast<float>(i));
+            vecs.emplace_back(Vector2{1.0f, 2.0f});
+        }
+
+        return ids.size() + values.size() + vecs.size();
+    };
+}
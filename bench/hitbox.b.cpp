@@ -0,0 +1,78 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "hitbox.hpp"
+#include <format>
+#include <random>
+#include <vector>
+
+namespace {
+    // rotated rectangles scattered around closely enough that about half of the pairs overlap
+    std::vector<shapes::Polygon> random_rectangles(std::mt19937& gen, std::size_t n) {
+        std::uniform_real_distribution<float> coord(0.0f, 40.0f);
+        std::uniform_real_distribution<float> size(5.0f, 20.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+
+        std::vector<shapes::Polygon> polys;
+        for (std::size_t i = 0; i < n; i++) {
+            auto& poly = polys.emplace_back(Rectangle{coord(gen), coord(gen), size(gen), size(gen)});
+            poly.rotate(angle(gen));
+        }
+
+        return polys;
+    }
+}
+
+TEST_CASE("check_collision", "[hitbox][!benchmark]") {
+    static constexpr std::size_t n = 1000;
+
+    std::mt19937 gen(42);
+    auto lhs = random_rectangles(gen, n);
+    auto rhs = random_rectangles(gen, n);
+
+    std::uniform_real_distribution<float> coord(0.0f, 40.0f);
+    std::uniform_real_distribution<float> radius(2.0f, 10.0f);
+    std::vector<shapes::Circle> circles;
+    std::vector<Vector2> points;
+    for (std::size_t i = 0; i < n; i++) {
+        circles.emplace_back(Vector2{coord(gen), coord(gen)}, radius(gen));
+        points.emplace_back(coord(gen), coord(gen));
+    }
+
+    BENCHMARK(std::format("polygon-polygon x{}", n)) {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            hits += check_collision(lhs[i], rhs[i]);
+        }
+
+        return hits;
+    };
+
+    BENCHMARK(std::format("polygon-circle x{}", n)) {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            hits += check_collision(lhs[i], circles[i]);
+        }
+
+        return hits;
+    };
+
+    BENCHMARK(std::format("polygon-point x{}", n)) {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            hits += check_collision(lhs[i], points[i]);
+        }
+
+        return hits;
+    };
+
+    BENCHMARK(std::format("circle-circle x{}", n)) {
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            hits += check_collision(circles[i], circles[n - 1 - i]);
+        }
+
+        return hits;
+    };
+}
@@ -0,0 +1,119 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "particle/kernels.hpp"
+#include "particle/particle.hpp"
+#include "particle/pipeline.hpp"
+#include <format>
+#include <random>
+#include <vector>
+
+// every benchmark name has the particle count in it, particles/s is that over the mean
+using namespace particle_system;
+
+namespace {
+    const char* name(kernels::Isa isa) {
+        switch (isa) {
+            case kernels::Isa::Scalar:
+                return "scalar";
+            case kernels::Isa::AVX2:
+                return "avx2";
+        }
+
+        std::unreachable();
+    }
+
+    // a full system, every particle alive and long lived enough to survive all the runs
+    Particles alive_particles(std::size_t n) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+
+        Particles particles(n);
+        for (std::size_t i = 0; i < n; i++) {
+            particles.pos[i] = {value(gen), value(gen), value(gen)};
+            particles.velocity[i] = {value(gen), value(gen), value(gen)};
+            particles.acceleration[i] = {value(gen), value(gen), value(gen)};
+            particles.color[i] = RED;
+            particles.lifetime[i] = 1e9f;
+            particles.wake(i);
+        }
+        return particles;
+    }
+}
+
+TEST_CASE("Particle kernels", "[particle][!benchmark]") {
+    auto n = GENERATE(100'000uz, 250'000uz, 1'000'000uz);
+    auto particles = alive_particles(n);
+
+    std::span pos(reinterpret_cast<float*>(particles.pos), 3 * n);
+    std::span velocity(reinterpret_cast<float*>(particles.velocity), 3 * n);
+    std::span acceleration(reinterpret_cast<const float*>(particles.acceleration), 3 * n);
+
+    for (auto isa : {kernels::Isa::Scalar, kernels::Isa::AVX2}) {
+        if (!kernels::supported(isa)) continue;
+
+        BENCHMARK(std::format("integrate {} particles, {}", n, name(isa))) {
+            kernels::integrate(pos, velocity, acceleration, 1e-6f, isa);
+            return pos[0];
+        };
+
+        BENCHMARK(std::format("decay {} particles, {}", n, name(isa))) {
+            kernels::decay({particles.lifetime, n}, 1e-6f, isa);
+            return particles.lifetime[0];
+        };
+
+        BENCHMARK(std::format("color by velocity {} particles, {}", n, name(isa))) {
+            kernels::color_by_velocity({particles.velocity, n}, {particles.color, n}, RED, YELLOW, 5.0f, 15.0f, isa);
+            return particles.color[0].r;
+        };
+    }
+}
+
+TEST_CASE("Particle updaters", "[particle][!benchmark]") {
+    auto n = GENERATE(100'000uz, 250'000uz, 1'000'000uz);
+    auto particles = alive_particles(n);
+
+    updaters::Lifetime lifetime;
+    updaters::Position position;
+    updaters::ColorByVelocity color(RED, YELLOW, 5.0f, 15.0f);
+
+    // what one tick of a system does with them, with whatever `best` picked
+    BENCHMARK(std::format("{} particles, {}", n, name(kernels::best()))) {
+        lifetime.update(particles, 1e-6f);
+        position.update(particles, 1e-6f);
+        color.update(particles, 1e-6f);
+        return particles.alive_count;
+    };
+}
+
+TEST_CASE("Particle pipelines", "[particle][!benchmark]") {
+    auto n = GENERATE(100'000uz, 250'000uz, 1'000'000uz);
+
+    auto size = [](Particles& particles, float, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            particles.size[i] = Vector3Length(particles.velocity[i]);
+        }
+    };
+
+    // the same updaters an explosion has, once as separate variants and once as a pipeline
+    System separate(n, renderers::Point(n));
+    separate.particles = alive_particles(n);
+    separate.add_updater(updaters::Position());
+    separate.add_updater(updaters::Lifetime());
+    separate.add_updater(updaters::ColorByVelocity(RED, YELLOW, 5.0f, 15.0f));
+    separate.add_updater([&](Particles& particles, float dt) { size(particles, dt, 0, particles.alive_count); });
+
+    System fused(n, renderers::Point(n));
+    fused.particles = alive_particles(n);
+    fused.add_updater(pipeline::Updaters(updaters::Position(), updaters::Lifetime(),
+                                         updaters::ColorByVelocity(RED, YELLOW, 5.0f, 15.0f), size));
+
+    BENCHMARK(std::format("{} particles, separate", n)) {
+        return separate.update(1e-6f);
+    };
+
+    BENCHMARK(std::format("{} particles, pipeline", n)) {
+        return fused.update(1e-6f);
+    };
+}
@@ -0,0 +1,197 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "hitbox.hpp"
+#include "quadtree.hpp"
+#include "utility.hpp"
+#include <format>
+#include <functional>
+#include <random>
+#include <vector>
+
+using P = quadtree::pos<uint32_t>;
+using QT = quadtree::QuadTree<10, P>;
+
+namespace {
+    // how queries were done before they got templated, kept around to compare against
+    void legacy_search_by(QT& qt, quadtree::Handle handle, std::function<bool(const quadtree::Box&)> check_box,
+                          std::function<bool(const P&)> check_data, std::function<void(P&, std::size_t)> f) {
+        auto& node = qt.nodes[handle];
+
+        if (!check_box(node.bbox)) return;
+
+        if (!node.subdivided) {
+            for (const auto& dat : node.data) {
+                auto data_ix = qt.data.lookup(dat);
+                if (!data_ix) continue;
+
+                if (check_data(qt.data.vec[*data_ix])) {
+                    f(qt.data.vec[*data_ix], *data_ix);
+                }
+            }
+
+            return;
+        }
+
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 2; x++) {
+                legacy_search_by(qt, node[y, x], check_box, check_data, f);
+            }
+        }
+    }
+
+    struct Scene {
+        QT qt;
+        std::size_t movers;
+        std::mt19937 gen{42};
+
+        Scene(std::size_t n, std::size_t movers) : qt(arena::arena_rec), movers(movers) {
+            std::uniform_real_distribution<float> x(arena::arena_rec.x, arena::arena_rec.x + ARENA_WIDTH);
+            std::uniform_real_distribution<float> y(arena::arena_rec.y, arena::arena_rec.y + ARENA_HEIGHT);
+
+            for (std::size_t i = 0; i < n; i++) {
+                qt.insert(Vector2{x(gen), y(gen)}, static_cast<uint32_t>(i));
+            }
+        }
+
+        // roughly how far an enemy walks in a tick
+        void move() {
+            std::uniform_real_distribution<float> step(-3.0f, 3.0f);
+
+            for (std::size_t i = 0; i < movers; i++) {
+                auto pos = qt.data.vec[i].position();
+                pos.x += step(gen);
+                pos.y += step(gen);
+                arena::loop_around(pos.x, pos.y);
+                qt.data.vec[i].set_position(pos);
+            }
+        }
+    };
+}
+
+TEST_CASE("Quadtree insert", "[quadtree][!benchmark]") {
+    std::size_t n = GENERATE(1000, 10000, 50000);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> x(arena::arena_rec.x, arena::arena_rec.x + ARENA_WIDTH);
+    std::uniform_real_distribution<float> y(arena::arena_rec.y, arena::arena_rec.y + ARENA_HEIGHT);
+    std::vector<Vector2> points;
+    for (std::size_t i = 0; i < n; i++) {
+        points.emplace_back(x(gen), y(gen));
+    }
+
+    BENCHMARK(std::format("insert n={}", n)) {
+        QT qt(arena::arena_rec);
+        for (std::size_t i = 0; i < n; i++) {
+            qt.insert(points[i], static_cast<uint32_t>(i));
+        }
+
+        return qt.nodes->size();
+    };
+}
+
+TEST_CASE("Quadtree tick", "[quadtree][!benchmark]") {
+    std::size_t n = GENERATE(1000, 10000);
+    std::size_t movers_percent = GENERATE(1, 10, 100);
+    Scene scene(n, n * movers_percent / 100);
+
+    BENCHMARK(std::format("update n={} movers={}%", n, movers_percent)) {
+        scene.move();
+        for (std::size_t i = 0; i < scene.movers; i++) {
+            scene.qt.update(i);
+        }
+        scene.qt.maintain();
+
+        return scene.qt.nodes->size();
+    };
+
+    BENCHMARK(std::format("rebuild n={} movers={}%", n, movers_percent)) {
+        scene.move();
+        scene.qt.rebuild();
+
+        return scene.qt.nodes->size();
+    };
+}
+
+// same shape as the separation pass in `EnemyPool::update_target`, one neighbourhood query per entry
+TEST_CASE("Quadtree query", "[quadtree][!benchmark]") {
+    static constexpr float neighbourhood_radius = 100.0f;
+
+    std::size_t n = GENERATE(1000, 10000, 50000);
+    Scene scene(n, 0);
+    auto& qt = scene.qt;
+
+    BENCHMARK(std::format("templated n={}", n)) {
+        std::size_t hits = 0;
+
+        for (std::size_t i = 0; i < qt.data->size(); i++) {
+            shapes::Circle circle(qt.data.vec[i].position(), neighbourhood_radius);
+
+            qt.search_by(
+                [&circle](const quadtree::Box& bbox) { return bbox.intersect(circle); },
+                [&circle](const P& p) { return check_collision(circle, p.position()); },
+                [&](const P&, std::size_t ix) { hits += ix != i; });
+        }
+
+        return hits;
+    };
+
+    BENCHMARK(std::format("std::function n={}", n)) {
+        std::size_t hits = 0;
+
+        for (std::size_t i = 0; i < qt.data->size(); i++) {
+            shapes::Circle circle(qt.data.vec[i].position(), neighbourhood_radius);
+
+            legacy_search_by(
+                qt, qt.root,
+                [&circle](const quadtree::Box& bbox) { return bbox.intersect(circle); },
+                [&circle](const P& p) { return check_collision(circle, p.position()); },
+                [&](const P&, std::size_t ix) { hits += ix != i; });
+        }
+
+        return hits;
+    };
+}
+
+// target selection for `ClosestEnemy` spells
+TEST_CASE("Quadtree closest", "[quadtree][!benchmark]") {
+    std::size_t n = GENERATE(1000, 10000, 50000);
+    Scene scene(n, 0);
+    QT qt(arena::arena_rec, true);
+    for (const auto& p : *scene.qt.data) {
+        qt.insert(p.position(), uint32_t(*p));
+    }
+
+    std::uniform_real_distribution<float> x(arena::arena_rec.x, arena::arena_rec.x + ARENA_WIDTH);
+    std::uniform_real_distribution<float> y(arena::arena_rec.y, arena::arena_rec.y + ARENA_HEIGHT);
+    std::vector<Vector2> points;
+    for (int i = 0; i < 100; i++) {
+        points.emplace_back(x(scene.gen), y(scene.gen));
+    }
+
+    BENCHMARK(std::format("best-first n={}", n)) {
+        std::size_t acc = 0;
+        for (const auto& point : points) {
+            acc += *qt.closest_to(point);
+        }
+
+        return acc;
+    };
+
+    BENCHMARK(std::format("linear n={}", n)) {
+        std::size_t acc = 0;
+        for (const auto& point : points) {
+            std::size_t closest = 0;
+            for (std::size_t i = 1; i < qt.data->size(); i++) {
+                if (qt.distance_sqr(qt.data.vec[i].position(), point) <
+                    qt.distance_sqr(qt.data.vec[closest].position(), point)) {
+                    closest = i;
+                }
+            }
+            acc += closest;
+        }
+
+        return acc;
+    };
+}
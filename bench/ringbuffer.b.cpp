@@ -0,0 +1,83 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "ringbuffer.hpp"
+#include <cstdint>
+#include <format>
+#include <random>
+#include <vector>
+
+TEST_CASE("RingBuffer", "[ringbuffer][!benchmark]") {
+    std::size_t n = GENERATE(1000, 100000);
+
+    BENCHMARK(std::format("emplace_back n={}", n)) {
+        RingBuffer<uint64_t> rb;
+        for (std::size_t i = 0; i < n; i++) {
+            rb.emplace_back(i);
+        }
+
+        return rb.size();
+    };
+
+    // a queue that stays the same size, the indices keep wrapping around
+    BENCHMARK(std::format("queue n={}", n)) {
+        RingBuffer<uint64_t> rb(n);
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < n / 2; i++) {
+            rb.emplace_back(i);
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            acc += rb.front();
+            rb.pop_front();
+            rb.emplace_back(i);
+        }
+
+        return acc;
+    };
+
+    RingBuffer<uint64_t> full(n);
+    for (std::size_t i = 0; i < n; i++) {
+        full.emplace_back(i);
+    }
+    // start somewhere in the middle of the buffer, so iterating has to wrap
+    for (std::size_t i = 0; i < n / 3; i++) {
+        full.pop_front();
+        full.emplace_back(i);
+    }
+
+    BENCHMARK(std::format("iterate n={}", n)) {
+        uint64_t acc = 0;
+        for (auto x : full) {
+            acc += x;
+        }
+
+        return acc;
+    };
+
+    // what removing a spell from the spellbook does
+    std::mt19937 gen(42);
+    std::vector<std::size_t> removals;
+    for (std::size_t i = 0; i < 100; i++) {
+        removals.emplace_back(std::uniform_int_distribution<std::size_t>(0, n - 101)(gen));
+    }
+
+    BENCHMARK_ADVANCED(std::format("remove n={}", n))(Catch::Benchmark::Chronometer meter) {
+        std::vector<RingBuffer<uint64_t>> rbs;
+        for (int i = 0; i < meter.runs(); i++) {
+            auto& rb = rbs.emplace_back(n);
+            for (std::size_t j = 0; j < n; j++) {
+                rb.emplace_back(j);
+            }
+        }
+
+        meter.measure([&](int run) {
+            auto& rb = rbs[static_cast<std::size_t>(run)];
+            for (auto ix : removals) {
+                rb.remove(ix);
+            }
+
+            return rb.size();
+        });
+    };
+}
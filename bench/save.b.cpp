@@ -0,0 +1,43 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "player.hpp"
+#include "seria_deser.hpp"
+#include "spell.hpp"
+#include "utility.hpp"
+#include <format>
+#include <sstream>
+#include <string>
+
+// what `PlayerSave::save` and `PlayerSave::load_save` do, minus the file
+TEST_CASE("Save serialization", "[seria_deser][!benchmark]") {
+    std::size_t spell_count = GENERATE(10, 100, 1000);
+
+    rng::seed(42);
+    PlayerSave save;
+    save.add_souls(123456);
+    for (std::size_t i = 0; i < spell_count; i++) {
+        save.add_spell_to_spellbook(Spell::random(100));
+    }
+
+    BENCHMARK(std::format("serialize spells={}", spell_count)) {
+        std::stringstream out(std::ios::out | std::ios::binary);
+        seria_deser::serialize(CURRENT_VERSION, out);
+        save.serialize(out);
+
+        return out.tellp();
+    };
+
+    std::stringstream serialized(std::ios::out | std::ios::binary);
+    seria_deser::serialize(CURRENT_VERSION, serialized);
+    save.serialize(serialized);
+    auto bytes = serialized.str();
+
+    BENCHMARK(std::format("deserialize spells={}", spell_count)) {
+        std::stringstream in(bytes, std::ios::in | std::ios::binary);
+        auto v = seria_deser::deserialize_version(in);
+
+        return PlayerSave::deserialize(in, v).get_spellbook().size();
+    };
+}
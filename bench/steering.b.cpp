@@ -0,0 +1,69 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "steering.hpp"
+#include "utility.hpp"
+#include <format>
+#include <random>
+#include <vector>
+
+namespace {
+    const char* name(steering::Isa isa) {
+        switch (isa) {
+            case steering::Isa::Scalar:
+                return "scalar";
+            case steering::Isa::SSE:
+                return "sse";
+            case steering::Isa::AVX2:
+                return "avx2";
+        }
+
+        std::unreachable();
+    }
+
+    std::vector<float> random_coords(std::mt19937& gen, std::size_t n, float spread) {
+        std::uniform_real_distribution<float> coord(-spread, spread);
+
+        std::vector<float> v(n);
+        for (auto& c : v) {
+            c = coord(gen);
+        }
+        return v;
+    }
+}
+
+TEST_CASE("Steering attraction", "[steering][!benchmark]") {
+    auto n = GENERATE(500uz, 5000uz, 50000uz);
+
+    std::mt19937 gen(42);
+    auto xs = random_coords(gen, n, ARENA_WIDTH / 2.0f);
+    auto ys = random_coords(gen, n, ARENA_HEIGHT / 2.0f);
+    std::vector<float> out_x(n), out_y(n), angles(n);
+
+    for (auto isa : {steering::Isa::Scalar, steering::Isa::SSE, steering::Isa::AVX2}) {
+        if (!steering::supported(isa)) continue;
+
+        BENCHMARK(std::format("{} enemies, {}", n, name(isa))) {
+            steering::attraction({12.0f, -40.0f}, xs, ys, out_x, out_y, angles, isa);
+            return angles[n - 1];
+        };
+    }
+}
+
+TEST_CASE("Steering separation", "[steering][!benchmark]") {
+    // how many enemies end up in one neighbourhood, from sparse to a crowd around the player
+    auto n = GENERATE(8uz, 64uz, 512uz);
+
+    std::mt19937 gen(42);
+    auto xs = random_coords(gen, n, steering::neighbourhood_radius);
+    auto ys = random_coords(gen, n, steering::neighbourhood_radius);
+
+    for (auto isa : {steering::Isa::Scalar, steering::Isa::SSE, steering::Isa::AVX2}) {
+        if (!steering::supported(isa)) continue;
+
+        BENCHMARK(std::format("{} neighbours, {}", n, name(isa))) {
+            return steering::separation({0.0f, 0.0f}, xs, ys, isa);
+        };
+    }
+}
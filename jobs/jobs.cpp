@@ -0,0 +1,112 @@
+#include "jobs.hpp"
+
+namespace {
+    // which queue the current thread owns, only set on workers
+    thread_local const jobs::Pool* current_pool = nullptr;
+    thread_local std::size_t current_queue = 0;
+}
+
+namespace jobs {
+    Pool::Pool(std::size_t workers) {
+        for (std::size_t i = 0; i < workers + 1; i++) {
+            queues.emplace_back(std::make_unique<Queue>());
+        }
+
+        for (std::size_t i = 1; i <= workers; i++) {
+            threads.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    Pool::~Pool() {
+        {
+            std::lock_guard lock(sleep_mutex);
+            stop = true;
+        }
+        sleep.notify_all();
+
+        threads.clear();
+    }
+
+    std::size_t Pool::own_queue() const {
+        return current_pool == this ? current_queue : 0;
+    }
+
+    void Pool::push(std::size_t queue_ix, Task task) {
+        auto& queue = *queues[queue_ix];
+
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.emplace_back(task);
+        queued.fetch_add(1, std::memory_order_release);
+    }
+
+    void Pool::wake() {
+        // taking the lock makes sure nobody is between checking `queued` and going to sleep
+        { std::lock_guard lock(sleep_mutex); }
+        sleep.notify_all();
+    }
+
+    std::optional<Pool::Task> Pool::find(std::size_t queue_ix) {
+        if (queued.load(std::memory_order_acquire) == 0) return std::nullopt;
+
+        for (std::size_t i = 0; i < queues.size(); i++) {
+            auto& queue = *queues[(queue_ix + i) % queues.size()];
+
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+
+            // newest from our own queue, it's the most likely to still be in cache, oldest from everyone else
+            auto task = i == 0 ? queue.tasks.back() : queue.tasks.front();
+            if (i == 0) {
+                queue.tasks.pop_back();
+            } else {
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+
+            return task;
+        }
+
+        return std::nullopt;
+    }
+
+    void Pool::execute(const Task& task) {
+        task.run(task.ctx, task.begin, task.end);
+        task.remaining->fetch_sub(1, std::memory_order_release);
+    }
+
+    void Pool::help_until(std::size_t queue_ix, const std::atomic<std::size_t>& remaining) {
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (auto task = find(queue_ix); task) {
+                execute(*task);
+            } else {
+                // the last chunks are running somewhere else
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void Pool::work(std::size_t queue_ix) {
+        current_pool = this;
+        current_queue = queue_ix;
+
+        while (true) {
+            if (auto task = find(queue_ix); task) {
+                execute(*task);
+                continue;
+            }
+
+            std::unique_lock lock(sleep_mutex);
+            sleep.wait(lock, [this] { return stop || queued.load(std::memory_order_acquire) != 0; });
+            if (stop) return;
+        }
+    }
+
+    Pool& pool() {
+#if defined(PLATFORM_WEB) || defined(JOBS_SINGLE_THREADED)
+        static Pool p(0);
+#else
+        static Pool p(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+#endif
+        return p;
+    }
+}
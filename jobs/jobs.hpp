@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace jobs {
+    // small work-stealing thread pool
+    // every thread has its own queue, it takes work from the back of it and steals from the front of the others
+    // the thread that called `parallel_for` helps out until its whole batch is done, so nesting doesn't deadlock
+    class Pool {
+      public:
+        // 0 workers runs everything on the calling thread
+        explicit Pool(std::size_t workers);
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+        ~Pool();
+
+        // workers + the calling thread
+        std::size_t thread_count() const {
+            return threads.size() + 1;
+        }
+
+        // splits [0, n) into chunks of at most `grain` indices and calls `f(begin, end)` for each, possibly on
+        // different threads at the same time, returns once all of them finished
+        template <typename F> void parallel_for(std::size_t n, std::size_t grain, F&& f) {
+            if (n == 0) return;
+            if (grain == 0) grain = 1;
+
+            if (threads.empty() || n <= grain) {
+                for (std::size_t begin = 0; begin < n; begin += grain) {
+                    f(begin, std::min(begin + grain, n));
+                }
+                return;
+            }
+
+            using Fn = std::remove_reference_t<F>;
+
+            std::atomic<std::size_t> remaining = (n + grain - 1) / grain;
+            auto run = [](void* ctx, std::size_t begin, std::size_t end) { (*static_cast<Fn*>(ctx))(begin, end); };
+
+            // spread out from our own queue, whatever isn't picked up by the others we end up doing ourselves
+            auto own = own_queue();
+            std::size_t chunk = 0;
+            for (std::size_t begin = 0; begin < n; begin += grain, chunk++) {
+                push((own + chunk) % queues.size(), Task{
+                                                .run = run,
+                                                .ctx = const_cast<void*>(static_cast<const void*>(std::addressof(f))),
+                                                .begin = begin,
+                                                .end = std::min(begin + grain, n),
+                                                .remaining = &remaining,
+                                            });
+            }
+            wake();
+
+            help_until(own, remaining);
+        }
+
+      private:
+        struct Task {
+            void (*run)(void*, std::size_t, std::size_t);
+            void* ctx;
+            std::size_t begin;
+            std::size_t end;
+            std::atomic<std::size_t>* remaining;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        // queue 0 belongs to whoever isn't a worker, workers own 1..
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::jthread> threads;
+
+        std::atomic<std::size_t> queued = 0;
+        std::mutex sleep_mutex;
+        std::condition_variable sleep;
+        bool stop = false;
+
+        std::size_t own_queue() const;
+        void push(std::size_t queue_ix, Task task);
+        void wake();
+        // own queue first, then everyone else's
+        std::optional<Task> find(std::size_t queue_ix);
+        void execute(const Task& task);
+        void help_until(std::size_t queue_ix, const std::atomic<std::size_t>& remaining);
+        void work(std::size_t queue_ix);
+    };
+
+    // shared by the whole game, one worker per core minus the render thread, none on the web or with
+    // JOBS_SINGLE_THREADED
+    Pool& pool();
+}
@@ -1,5 +1,8 @@
 #include "effects.hpp"
+#include "jobs.hpp"
 #include "particle.hpp"
+#include "pipeline.hpp"
+#include "profiler.hpp"
 #include <ranges>
 
 namespace effect {
@@ -15,8 +18,8 @@ namespace effect {
         System system(particle_count, renderers::Point(particle_count));
 
         emitters::CustomEmitter emitter(emit_rate, max_emit);
-        emitter.add_generator(generators::pos::OnSphere(origin, {radius * 0.7f, radius + 1.0f}));
-        emitter.add_generator(
+        emitter.add_generator(pipeline::Generators(
+            generators::pos::OnSphere(origin, {radius * 0.7f, radius + 1.0f}),
             [origin = origin, type = type](Particles& particles, float _, std::size_t start_ix, std::size_t end_ix) {
                 for (std::size_t i = start_ix; i < end_ix; i++) {
                     switch (type) {
@@ -28,18 +31,18 @@ namespace effect {
                             break;
                     }
                 }
-            });
-        emitter.add_generator(generators::velocity::ScaleRange(velocity_scale.first, velocity_scale.second));
-        emitter.add_generator(generators::acceleration::Uniform(acceleration));
-        emitter.add_generator(generators::color::Fixed(WHITE));
-        emitter.add_generator(generators::lifetime::Range(lifetime.first, lifetime.second));
-        emitter.add_generator([](Particles& particles, float _, std::size_t start_ix, std::size_t end_ix) {
-            for (std::size_t i = start_ix; i < end_ix; i++) {
-                particles.size[i] = Vector3Length(particles.velocity[i]);
-            }
-        });
+            },
+            generators::velocity::ScaleRange(velocity_scale.first, velocity_scale.second),
+            generators::acceleration::Uniform(acceleration), generators::color::Fixed(WHITE),
+            generators::lifetime::Range(lifetime.first, lifetime.second),
+            [](Particles& particles, float _, std::size_t start_ix, std::size_t end_ix) {
+                for (std::size_t i = start_ix; i < end_ix; i++) {
+                    particles.size[i] = Vector3Length(particles.velocity[i]);
+                }
+            }));
         system.add_emitter(std::move(emitter));
 
+        // kills right away, so it can't be a part of the pipeline below
         if (floor_y || type == Im) {
             system.add_updater([y = floor_y, type = type, origin = origin](Particles& particles, float _) {
                 auto end_ix = particles.alive_count;
@@ -53,15 +56,14 @@ namespace effect {
                 }
             });
         }
-        system.add_updater(updaters::Position());
-        system.add_updater(updaters::Lifetime());
-        system.add_updater(
-            updaters::ColorByVelocity(color.first.first, color.second.first, color.first.second, color.second.second));
-        system.add_updater([scale = particle_size_scale](Particles& particles, float _) {
-            for (std::size_t i = 0; i < particles.alive_count; i++) {
-                particles.size[i] = scale * Vector3Length(particles.velocity[i]);
-            }
-        });
+        system.add_updater(pipeline::Updaters(
+            updaters::Position(), updaters::Lifetime(),
+            updaters::ColorByVelocity(color.first.first, color.second.first, color.first.second, color.second.second),
+            [scale = particle_size_scale](Particles& particles, float _, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    particles.size[i] = scale * Vector3Length(particles.velocity[i]);
+                }
+            }));
 
         return system;
     }
@@ -78,32 +80,29 @@ namespace effect {
         System system(particle_count, renderers::Point(particle_count));
 
         emitters::CustomEmitter emitter(emit_rate, std::numeric_limits<std::size_t>::max());
-        emitter.add_generator(generators::pos::OnCircle(origin, {2.0f * 0.7f, 3.0f}));
-        emitter.add_generator(
+        emitter.add_generator(pipeline::Generators(
+            generators::pos::OnCircle(origin, {2.0f * 0.7f, 3.0f}),
             [origin = origin](Particles& particles, float _, std::size_t start_ix, std::size_t end_ix) {
                 for (std::size_t i = start_ix; i < end_ix; i++) {
                     particles.velocity[i] = Vector3Normalize(Vector3Subtract(particles.pos[i], origin));
                 }
-            });
-        emitter.add_generator(generators::velocity::ScaleRange(10.0f, 30.0f));
-        emitter.add_generator(generators::acceleration::Uniform({50.0f, 0.0f, 50.0f}));
-        emitter.add_generator(generators::color::Fixed(WHITE));
-        emitter.add_generator(generators::lifetime::Range(0.1f, 0.6f));
-        emitter.add_generator([](Particles& particles, float _, std::size_t start_ix, std::size_t end_ix) {
-            for (std::size_t i = start_ix; i < end_ix; i++) {
-                particles.size[i] = Vector3Length(particles.velocity[i]);
-            }
-        });
+            },
+            generators::velocity::ScaleRange(10.0f, 30.0f), generators::acceleration::Uniform({50.0f, 0.0f, 50.0f}),
+            generators::color::Fixed(WHITE), generators::lifetime::Range(0.1f, 0.6f),
+            [](Particles& particles, float _, std::size_t start_ix, std::size_t end_ix) {
+                for (std::size_t i = start_ix; i < end_ix; i++) {
+                    particles.size[i] = Vector3Length(particles.velocity[i]);
+                }
+            }));
         system.add_emitter(std::move(emitter));
 
-        system.add_updater(updaters::Position());
-        system.add_updater(updaters::Lifetime());
-        system.add_updater(updaters::ColorByVelocity(rarity_color, WHITE, 0.0f, 120.0f));
-        system.add_updater([](Particles& particles, float _) {
-            for (std::size_t i = 0; i < particles.alive_count; i++) {
-                particles.size[i] = 0.05f * Vector3Length(particles.velocity[i]);
-            }
-        });
+        system.add_updater(pipeline::Updaters(
+            updaters::Position(), updaters::Lifetime(), updaters::ColorByVelocity(rarity_color, WHITE, 0.0f, 120.0f),
+            [](Particles& particles, float _, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    particles.size[i] = 0.05f * Vector3Length(particles.velocity[i]);
+                }
+            }));
 
         return system;
     }
@@ -143,26 +142,54 @@ namespace effects {
     }
 
     void update(float dt) {
+        profiler::Scope zone("effects::update");
+
+        // every system only touches itself and has its own rng, so they can all step at once and still end up exactly
+        // where they would one after another
+        static std::vector<char> simulating;
+        simulating.assign(_effects.size(), false);
+        jobs::pool().parallel_for(_effects.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                simulating[i] = _effects[i].second.update(dt);
+            }
+        });
+
+        // the finished ones get removed in the same order as before, `Id`s still point at the right place
         std::size_t i = 0;
         while (i < _effects.size()) {
-            if (_effects[i].second.update(dt)) {
+            if (simulating[i]) {
                 i++;
                 continue;
             }
 
             std::swap(_effects[i], _effects.back());
+            std::swap(simulating[i], simulating.back());
             _effects.pop_back();
+            simulating.pop_back();
         }
     }
 
-    void draw(Vector3 offset) {
-        for (std::size_t i = 0; i < _effects.size(); i++) {
-            std::get<1>(_effects[i]).draw(offset);
+    void draw(std::span<const Vector3> offsets) {
+        profiler::Scope zone("effects::draw");
+
+        for (auto& [_, system] : _effects) {
+            if (auto point = std::get_if<particle_system::renderers::Point>(&system.renderer); point) {
+                particle_system::renderers::shared::batch(system.particles, point->pos_offset);
+                continue;
+            }
+
+            for (const auto& offset : offsets) {
+                system.draw(offset);
+            }
         }
+
+        particle_system::renderers::shared::flush(offsets);
     }
 
     void clean() {
         _effects.clear();
         _effects.shrink_to_fit();
+        particle_system::renderers::shared::unload();
+        particle_system::storage::trim();
     }
 }
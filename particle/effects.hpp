@@ -4,6 +4,7 @@
 #include <limits>
 #include <optional>
 #include <raylib.h>
+#include <span>
 #include <utility>
 #include <variant>
 
@@ -61,7 +62,9 @@ namespace effects {
     Id push_effect(particle_system::System&& eff);
     void pop_effect(Id id);
 
+    // the systems get spread over `jobs::pool`, one per task
     void update(float dt);
-    void draw(Vector3 offset);
+    // every effect drawn at every offset, all the point particles in a single draw call
+    void draw(std::span<const Vector3> offsets);
     void clean();
 }
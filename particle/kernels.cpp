@@ -0,0 +1,179 @@
+#include "kernels.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <raymath.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PARTICLE_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    using particle_system::kernels::Isa;
+
+    // the reference the wide kernels get tested against, same math the updaters used to do per particle
+    Color color_by_velocity_scalar(Vector3 velocity, Color color, Color start, Color end, float min_threshold,
+                                   float max_threshold) {
+        auto speed = std::abs(Vector3Length(velocity));
+        auto factor = (speed - min_threshold) / (max_threshold - min_threshold);
+
+        if (factor < 0.0f) {
+            return ColorLerp(color, start, std::abs(speed / min_threshold));
+        } else {
+            return ColorLerp(start, end, factor);
+        }
+    }
+
+#ifdef PARTICLE_X86
+    __attribute__((target("avx2"))) void integrate_avx2(float* pos, float* velocity, const float* acceleration,
+                                                         float dt, std::size_t n) {
+        const __m256 dts = _mm256_set1_ps(dt);
+
+        for (std::size_t i = 0; i < n; i += 8) {
+            __m256 v = _mm256_add_ps(_mm256_loadu_ps(velocity + i),
+                                     _mm256_mul_ps(_mm256_loadu_ps(acceleration + i), dts));
+            _mm256_storeu_ps(velocity + i, v);
+            _mm256_storeu_ps(pos + i, _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_mul_ps(v, dts)));
+        }
+    }
+
+    __attribute__((target("avx2"))) void decay_avx2(float* lifetime, float dt, std::size_t n) {
+        const __m256 dts = _mm256_set1_ps(dt);
+
+        for (std::size_t i = 0; i < n; i += 8) {
+            _mm256_storeu_ps(lifetime + i, _mm256_sub_ps(_mm256_loadu_ps(lifetime + i), dts));
+        }
+    }
+
+    // `ColorLerp` for 8 colors at once, `t` gets clamped to [0, 1] the same way and the result truncated the same way
+    __attribute__((target("avx2"))) __m256i lerp_colors_avx2(__m256i a, __m256i b, __m256 t) {
+        const __m256i byte = _mm256_set1_epi32(0xFF);
+        t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+        __m256 s = _mm256_sub_ps(_mm256_set1_ps(1.0f), t);
+
+        __m256i result = _mm256_setzero_si256();
+        for (int shift = 0; shift < 32; shift += 8) {
+            __m256 ca = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(a, shift), byte));
+            __m256 cb = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(b, shift), byte));
+            __m256i c = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(s, ca), _mm256_mul_ps(t, cb)));
+            result = _mm256_or_si256(result, _mm256_slli_epi32(_mm256_and_si256(c, byte), shift));
+        }
+
+        return result;
+    }
+
+    __attribute__((target("avx2"))) void color_by_velocity_avx2(const Vector3* velocity, Color* color, Color start,
+                                                                 Color end, float min_threshold, float max_threshold,
+                                                                 std::size_t n) {
+        static_assert(sizeof(Vector3) == 3 * sizeof(float) && sizeof(Color) == sizeof(int));
+
+        const __m256i xyz = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+        const __m256 min = _mm256_set1_ps(min_threshold);
+        const __m256 range = _mm256_set1_ps(max_threshold - min_threshold);
+        int start_bits, end_bits;
+        std::memcpy(&start_bits, &start, sizeof(Color));
+        std::memcpy(&end_bits, &end, sizeof(Color));
+        const __m256i starts = _mm256_set1_epi32(start_bits);
+        const __m256i ends = _mm256_set1_epi32(end_bits);
+
+        for (std::size_t i = 0; i < n; i += 8) {
+            const float* v = reinterpret_cast<const float*>(velocity + i);
+            __m256 x = _mm256_i32gather_ps(v, xyz, 4);
+            __m256 y = _mm256_i32gather_ps(v + 1, xyz, 4);
+            __m256 z = _mm256_i32gather_ps(v + 2, xyz, 4);
+            __m256 speed = _mm256_sqrt_ps(
+                _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+
+            __m256 factor = _mm256_div_ps(_mm256_sub_ps(speed, min), range);
+            __m256 slow = _mm256_cmp_ps(factor, _mm256_setzero_ps(), _CMP_LT_OQ);
+            __m256 fade = _mm256_andnot_ps(sign, _mm256_div_ps(speed, min));
+
+            auto current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(color + i));
+            auto faded = lerp_colors_avx2(current, starts, fade);
+            auto ramped = lerp_colors_avx2(starts, ends, factor);
+            auto result = _mm256_blendv_epi8(ramped, faded, _mm256_castps_si256(slow));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(color + i), result);
+        }
+    }
+#endif
+
+    // how many of the first `n` elements the wide kernel takes care of, the rest goes through the scalar path
+    std::size_t batched(std::size_t n, Isa isa) {
+        switch (isa) {
+            case Isa::Scalar:
+                return 0;
+            case Isa::AVX2:
+                return n - n % 8;
+        }
+
+        std::unreachable();
+    }
+}
+
+namespace particle_system::kernels {
+    Isa best() {
+        static const Isa isa = [] {
+#ifdef PARTICLE_X86
+            if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+#endif
+            return Isa::Scalar;
+        }();
+
+        return isa;
+    }
+
+    bool supported(Isa isa) {
+        return static_cast<int>(isa) <= static_cast<int>(best());
+    }
+
+    void integrate(std::span<float> pos, std::span<float> velocity, std::span<const float> acceleration, float dt,
+                   Isa isa) {
+        assert(supported(isa));
+        assert(velocity.size() == pos.size() && acceleration.size() == pos.size());
+
+        std::size_t wide = batched(pos.size(), isa);
+#ifdef PARTICLE_X86
+        if (isa == Isa::AVX2) integrate_avx2(pos.data(), velocity.data(), acceleration.data(), dt, wide);
+#endif
+
+        for (std::size_t i = wide; i < pos.size(); i++) {
+            velocity[i] = velocity[i] + acceleration[i] * dt;
+            pos[i] = pos[i] + velocity[i] * dt;
+        }
+    }
+
+    void decay(std::span<float> lifetime, float dt, Isa isa) {
+        assert(supported(isa));
+
+        std::size_t wide = batched(lifetime.size(), isa);
+#ifdef PARTICLE_X86
+        if (isa == Isa::AVX2) decay_avx2(lifetime.data(), dt, wide);
+#endif
+
+        for (std::size_t i = wide; i < lifetime.size(); i++) {
+            lifetime[i] -= dt;
+        }
+    }
+
+    void color_by_velocity(std::span<const Vector3> velocity, std::span<Color> color, Color start, Color end,
+                           float min_threshold, float max_threshold, Isa isa) {
+        assert(supported(isa));
+        assert(color.size() == velocity.size());
+
+        std::size_t wide = batched(velocity.size(), isa);
+#ifdef PARTICLE_X86
+        if (isa == Isa::AVX2) {
+            color_by_velocity_avx2(velocity.data(), color.data(), start, end, min_threshold, max_threshold, wide);
+        }
+#endif
+
+        for (std::size_t i = wide; i < velocity.size(); i++) {
+            color[i] = color_by_velocity_scalar(velocity[i], color[i], start, end, min_threshold, max_threshold);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <raylib.h>
+
+// batched particle math for the updaters, every kernel has a scalar version and x86 gets an 8 wide (AVX2) one
+// picked at runtime
+// `Vector3` arrays are just 3 floats per particle back to back, so anything that treats x, y and z the same way runs
+// over them as one flat stream without splitting them up first
+namespace particle_system::kernels {
+    enum struct Isa {
+        Scalar,
+        AVX2,
+    };
+
+    // the widest one this cpu can run, checked once
+    Isa best();
+    bool supported(Isa isa);
+
+    // velocity += acceleration * dt, then pos += velocity * dt
+    // all spans have to be the same size
+    void integrate(std::span<float> pos, std::span<float> velocity, std::span<const float> acceleration, float dt,
+                   Isa isa = best());
+
+    // lifetime -= dt
+    void decay(std::span<float> lifetime, float dt, Isa isa = best());
+
+    // `updaters::ColorByVelocity`, slower particles fade towards `start`, faster ones go from `start` to `end`
+    // both spans have to be the same size
+    void color_by_velocity(std::span<const Vector3> velocity, std::span<Color> color, Color start, Color end,
+                           float min_threshold, float max_threshold, Isa isa = best());
+}
@@ -1,30 +1,106 @@
 #include "particle.hpp"
+#include "kernels.hpp"
+#include "profiler.hpp"
+#include <bit>
 #include <chrono>
+#include <cstddef>
+#include <new>
+#include <optional>
 #include <random>
 #include <raylib.h>
 #include <raymath.h>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 
-std::mt19937 rng(static_cast<unsigned long>(std::chrono::steady_clock::now().time_since_epoch().count()));
+namespace {
+    // every system gets its own stream seeded from this one when it's created, so which thread ends up updating it
+    // doesn't change what it generates
+    std::mt19937 seeds(static_cast<unsigned long>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    // the stream of the system this thread is updating right now
+    thread_local std::mt19937* current_rng = &seeds;
+
+    std::mt19937& rng() {
+        return *current_rng;
+    }
+}
+
+namespace particle_system {
+    void seed(std::uint64_t seed) {
+        std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+        seeds.seed(seq);
+    }
+}
 
 namespace particle_system {
     constexpr unsigned char particle_circle_data[] = {
 #embed "../assets/particle_circle.png"
     };
 
-    Particles::Particles(std::size_t max_particles) : max_size(max_particles), alive_count(0) {
-        pos = new Vector3[max_size]{};
-        velocity = new Vector3[max_size]{};
-        acceleration = new Vector3[max_size]{};
-        color = new Color[max_size]{};
-        alive = new bool[max_size]{};
-        lifetime = new float[max_size]{};
-        size = new float[max_size]{};
+    namespace storage {
+        namespace {
+            // by block size, the same few effects get cast over and over so there aren't many different ones
+            std::unordered_map<std::size_t, std::vector<std::byte*>> free_blocks;
+        }
+
+        std::byte* acquire(std::size_t bytes) {
+            if (auto it = free_blocks.find(bytes); it != free_blocks.end() && !it->second.empty()) {
+                auto block = it->second.back();
+                it->second.pop_back();
+                return block;
+            }
+
+            return static_cast<std::byte*>(::operator new(bytes, std::align_val_t{alignment}));
+        }
+
+        void release(std::byte* block, std::size_t bytes) {
+            free_blocks[bytes].emplace_back(block);
+        }
+
+        void trim() {
+            for (auto& [_, blocks] : free_blocks) {
+                for (auto block : blocks) {
+                    ::operator delete(block, std::align_val_t{alignment});
+                }
+            }
+            free_blocks.clear();
+        }
     }
 
-    Particles::Particles(Particles&& p)
+    namespace {
+        std::size_t aligned_size(std::size_t bytes) {
+            return (bytes + storage::alignment - 1) / storage::alignment * storage::alignment;
+        }
+
+        template <typename T> T* carve(std::byte*& at, std::size_t count) {
+            auto array = reinterpret_cast<T*>(at);
+            at += aligned_size(sizeof(T) * count);
+            return array;
+        }
+    }
+
+    Particles::Particles(std::size_t max_particles)
+        : max_size(max_particles), alive_count(0),
+          block_size(aligned_size(sizeof(Vector3) * max_size) * 3 + aligned_size(sizeof(Color) * max_size) +
+                     aligned_size(sizeof(bool) * max_size) + aligned_size(sizeof(float) * max_size) * 2) {
+        block = storage::acquire(block_size);
+        // recycled blocks still hold the last system's particles
+        std::memset(block, 0, block_size);
+
+        auto at = block;
+        pos = carve<Vector3>(at, max_size);
+        velocity = carve<Vector3>(at, max_size);
+        acceleration = carve<Vector3>(at, max_size);
+        color = carve<Color>(at, max_size);
+        alive = carve<bool>(at, max_size);
+        lifetime = carve<float>(at, max_size);
+        size = carve<float>(at, max_size);
+    }
+
+    Particles::Particles(Particles&& p) noexcept
         : pos(p.pos), velocity(p.velocity), acceleration(p.acceleration), color(p.color), alive(p.alive),
-          lifetime(p.lifetime), size(p.size), max_size(p.max_size), alive_count(p.alive_count) {
+          lifetime(p.lifetime), size(p.size), max_size(p.max_size), alive_count(p.alive_count), block(p.block),
+          block_size(p.block_size) {
         p.pos = nullptr;
         p.velocity = nullptr;
         p.acceleration = nullptr;
@@ -34,16 +110,30 @@ namespace particle_system {
         p.size = nullptr;
         p.max_size = 0;
         p.alive_count = 0;
+        p.block = nullptr;
+        p.block_size = 0;
     };
 
+    Particles& Particles::operator=(Particles&& p) noexcept {
+        if (this != &p) {
+            std::swap(pos, p.pos);
+            std::swap(velocity, p.velocity);
+            std::swap(acceleration, p.acceleration);
+            std::swap(color, p.color);
+            std::swap(alive, p.alive);
+            std::swap(lifetime, p.lifetime);
+            std::swap(size, p.size);
+            std::swap(max_size, p.max_size);
+            std::swap(alive_count, p.alive_count);
+            std::swap(block, p.block);
+            std::swap(block_size, p.block_size);
+        }
+
+        return *this;
+    }
+
     Particles::~Particles() {
-        delete[] pos;
-        delete[] velocity;
-        delete[] acceleration;
-        delete[] color;
-        delete[] alive;
-        delete[] lifetime;
-        delete[] size;
+        if (block != nullptr) storage::release(block, block_size);
     }
 
     void Particles::kill(std::size_t ix) {
@@ -86,11 +176,11 @@ namespace particle_system::generators::pos {
     }
 
     void OnCircle::gen(Particles& particles, float dt, std::size_t start_ix, std::size_t end_ix) {
-        static std::uniform_real_distribution<float> distAngle(0.0f, 2 * static_cast<float>(std::numbers::pi));
+        std::uniform_real_distribution<float> distAngle(0.0f, 2 * static_cast<float>(std::numbers::pi));
 
         for (std::size_t i = start_ix; i < end_ix; i++) {
-            auto angle = distAngle(rng);
-            auto radius = radiusDist(rng);
+            auto angle = distAngle(rng());
+            auto radius = radiusDist(rng());
             particles.pos[i].x = center.x + radius * std::cos(angle);
             particles.pos[i].y = center.y;
             particles.pos[i].z = center.z + radius * std::sin(angle);
@@ -102,13 +192,13 @@ namespace particle_system::generators::pos {
     }
 
     void OnSphere::gen(Particles& particles, float dt, std::size_t start_ix, std::size_t end_ix) {
-        static std::uniform_real_distribution<float> distTheta(0.0f, 2 * static_cast<float>(std::numbers::pi));
-        static std::uniform_real_distribution<float> distPhi(0.0f, static_cast<float>(std::numbers::pi));
+        std::uniform_real_distribution<float> distTheta(0.0f, 2 * static_cast<float>(std::numbers::pi));
+        std::uniform_real_distribution<float> distPhi(0.0f, static_cast<float>(std::numbers::pi));
 
         for (std::size_t i = start_ix; i < end_ix; i++) {
-            auto radius = radiusDist(rng);
-            float theta = distTheta(rng);
-            float phi = distPhi(rng);
+            auto radius = radiusDist(rng());
+            float theta = distTheta(rng());
+            float phi = distPhi(rng());
 
             particles.pos[i] = {
                 .x = center.x + radius * std::sin(phi) * std::cos(theta),
@@ -124,12 +214,12 @@ namespace particle_system::generators::velocity {
     }
 
     void Sphere::gen(Particles& particles, float dt, std::size_t start_ix, std::size_t end_ix) {
-        static std::uniform_real_distribution<float> distTheta(0.0f, 2 * static_cast<float>(std::numbers::pi));
-        static std::uniform_real_distribution<float> distPhi(0.0f, static_cast<float>(std::numbers::pi));
+        std::uniform_real_distribution<float> distTheta(0.0f, 2 * static_cast<float>(std::numbers::pi));
+        std::uniform_real_distribution<float> distPhi(0.0f, static_cast<float>(std::numbers::pi));
 
         for (std::size_t i = start_ix; i < end_ix; i++) {
-            float theta = distTheta(rng);
-            float phi = distPhi(rng);
+            float theta = distTheta(rng());
+            float phi = distPhi(rng());
 
             particles.velocity[i] = {
                 .x = speed * std::sin(phi) * std::cos(theta),
@@ -148,7 +238,7 @@ namespace particle_system::generators::velocity {
 
     void ScaleRange::gen(Particles& particles, float dt, std::size_t start_ix, std::size_t end_ix) {
         for (std::size_t i = start_ix; i < end_ix; i++) {
-            particles.velocity[i] = Vector3Scale(particles.velocity[i], dist(rng));
+            particles.velocity[i] = Vector3Scale(particles.velocity[i], dist(rng()));
         }
     }
 }
@@ -195,30 +285,49 @@ namespace particle_system::generators::lifetime {
 
     void Range::gen(Particles& particles, float dt, std::size_t start_ix, std::size_t end_ix) {
         for (std::size_t i = start_ix; i < end_ix; i++) {
-            particles.lifetime[i] = dist(rng);
+            particles.lifetime[i] = dist(rng());
         }
     }
 }
 
 namespace particle_system::updaters {
     void Lifetime::update(Particles& particles, float dt) {
-        auto end_ix = particles.alive_count;
+        update(particles, dt, 0, particles.alive_count);
+        finish(particles);
+    }
 
-        for (std::size_t i = 0; i < end_ix; i++) {
-            particles.lifetime[i] -= dt;
+    void Lifetime::update(Particles& particles, float dt, std::size_t begin, std::size_t end) {
+        kernels::decay({particles.lifetime + begin, end - begin}, dt);
+    }
 
-            if (particles.lifetime[i] <= 0.0f) {
-                particles.kill(i);
-                end_ix = particles.alive_count < particles.max_size ? particles.alive_count : particles.max_size;
-            }
+    void Lifetime::finish(Particles& particles) {
+        // one pass over everything, the survivors slide down over the dead ones and keep their order
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < particles.alive_count; i++) {
+            if (particles.lifetime[i] <= 0.0f) continue;
+
+            if (i != kept) particles.swap(i, kept);
+            kept++;
+        }
+
+        for (std::size_t i = kept; i < particles.alive_count; i++) {
+            particles.alive[i] = false;
         }
+        particles.alive_count = kept;
     }
 
     void Position::update(Particles& particles, float dt) {
-        for (std::size_t i = 0; i < particles.alive_count; i++) {
-            particles.velocity[i] = Vector3Add(particles.velocity[i], Vector3Scale(particles.acceleration[i], dt));
-            particles.pos[i] = Vector3Add(particles.pos[i], Vector3Scale(particles.velocity[i], dt));
-        }
+        update(particles, dt, 0, particles.alive_count);
+    }
+
+    void Position::update(Particles& particles, float dt, std::size_t begin, std::size_t end) {
+        // x, y and z all get the same math, so the arrays can go through as flat floats
+        auto n = 3 * (end - begin);
+        std::span pos(reinterpret_cast<float*>(particles.pos + begin), n);
+        std::span velocity(reinterpret_cast<float*>(particles.velocity + begin), n);
+        std::span acceleration(reinterpret_cast<const float*>(particles.acceleration + begin), n);
+
+        kernels::integrate(pos, velocity, acceleration, dt);
     }
 
     ColorByVelocity::ColorByVelocity(Color start, Color end, float min_threshold, float max_threshold)
@@ -226,65 +335,184 @@ namespace particle_system::updaters {
     }
 
     void ColorByVelocity::update(Particles& particles, float dt) {
-        for (std::size_t i = 0; i < particles.alive_count; i++) {
-            auto speed = std::abs(Vector3Length(particles.velocity[i]));
-            auto factor = (speed - min_threshold) / (max_threshold - min_threshold);
+        update(particles, dt, 0, particles.alive_count);
+    }
 
-            if (factor < 0.0f) {
-                particles.color[i] = ColorLerp(particles.color[i], start_col, std::abs(speed / min_threshold));
-            } else {
-                particles.color[i] = ColorLerp(start_col, end_col, factor);
-            }
-        }
+    void ColorByVelocity::update(Particles& particles, float, std::size_t begin, std::size_t end) {
+        auto n = end - begin;
+
+        kernels::color_by_velocity({particles.velocity + begin, n}, {particles.color + begin, n}, start_col, end_col,
+                                   min_threshold, max_threshold);
     }
 }
 
-namespace particle_system::renderers {
-    Point::Point(std::size_t max_size, Vector3 pos_offset) : pos_offset(pos_offset), max_size(max_size) {
-        setup_gl();
+namespace particle_system::renderers::shared {
+    namespace {
+        std::optional<Program> loaded_program;
+        std::optional<Texture2D> loaded_circle;
+        std::vector<Buffers> pool;
+
+        std::vector<Vertex> batched;
+        unsigned int batch_vao_id = 0;
+        unsigned int batch_vbo_id = 0;
+        std::size_t batch_capacity = 0;
+
+        // the buffer gets a fresh store every upload, so the driver never has to wait for the last draw to finish
+        // reading the old one
+        void orphan_and_upload(unsigned int vbo_id, std::size_t capacity, const void* data, std::size_t size) {
+            profiler::Scope zone("particle upload");
+
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_id);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        void upload(const Buffers& buffers, const Particles& particles) {
+            orphan_and_upload(buffers.pos_vbo_id, Point::pos_vertex_size * buffers.capacity, particles.pos,
+                              Point::pos_vertex_size * particles.alive_count);
+            orphan_and_upload(buffers.size_vbo_id, Point::size_vertex_size * buffers.capacity, particles.size,
+                              Point::size_vertex_size * particles.alive_count);
+            orphan_and_upload(buffers.col_vbo_id, Point::col_vertex_size * buffers.capacity, particles.color,
+                              Point::col_vertex_size * particles.alive_count);
+        }
     }
 
-    Point::~Point() {
-        if (particle_circle.id != 0) UnloadTexture(particle_circle);
-        rlUnloadVertexArray(vao_id);
-        rlUnloadVertexBuffer(pos_vbo_id);
-        rlUnloadVertexBuffer(col_vbo_id);
-        rlUnloadVertexBuffer(col_vbo_id);
-        if (shader.id != 0) UnloadShader(shader);
+    const Program& program() {
+        if (!loaded_program) {
+            auto shader = LoadShader("./assets/particles.vs.glsl", "./assets/particles.fs.glsl");
+            loaded_program = Program{
+                .shader = shader,
+                .mvp_loc = GetShaderLocation(shader, "mvp"),
+                .offset_loc = GetShaderLocation(shader, "offset"),
+                .offsets_loc = GetShaderLocation(shader, "offsets"),
+                .circle_loc = GetShaderLocation(shader, "circle"),
+            };
+        }
+
+        return *loaded_program;
     }
 
-    void Point::operator()(Particles& particles, Vector3 offset) {
-        if (particles.alive_count == 0) return;
+    Texture2D circle() {
+        if (!loaded_circle) {
+            Image img = LoadImageFromMemory(".png", particle_circle_data, sizeof(particle_circle_data));
+            loaded_circle = LoadTextureFromImage(img);
+            UnloadImage(img);
+        }
 
-        BeginBlendMode(BLEND_ALPHA);
+        return *loaded_circle;
+    }
+
+    Buffers acquire(std::size_t capacity) {
+        auto best = pool.end();
+        for (auto it = pool.begin(); it != pool.end(); it++) {
+            if (it->capacity >= capacity && (best == pool.end() || it->capacity < best->capacity)) best = it;
+        }
 
-        std::memcpy(pos_vertex_data.get(), particles.pos, pos_vertex_size * particles.alive_count);
-        std::memcpy(size_vertex_data.get(), particles.size, size_vertex_size * particles.alive_count);
-        std::memcpy(col_vertex_data.get(), particles.color, col_vertex_size * particles.alive_count);
+        if (best != pool.end()) {
+            auto buffers = *best;
+            *best = pool.back();
+            pool.pop_back();
+            return buffers;
+        }
 
-        rlUpdateVertexBuffer(pos_vbo_id, pos_vertex_data.get(),
-                             static_cast<int>(pos_vertex_size * particles.alive_count), 0);
-        rlUpdateVertexBuffer(size_vbo_id, size_vertex_data.get(),
-                             static_cast<int>(size_vertex_size * particles.alive_count), 0);
-        rlUpdateVertexBuffer(col_vbo_id, col_vertex_data.get(),
-                             static_cast<int>(col_vertex_size * particles.alive_count), 0);
+        // rounded up, so systems of similar sizes end up sharing buffers
+        Buffers buffers{.capacity = std::bit_ceil(capacity)};
+        buffers.vao_id = rlLoadVertexArray();
+        buffers.pos_vbo_id =
+            rlLoadVertexBuffer(NULL, static_cast<int>(Point::pos_vertex_size * buffers.capacity), true);
+        buffers.size_vbo_id =
+            rlLoadVertexBuffer(NULL, static_cast<int>(Point::size_vertex_size * buffers.capacity), true);
+        buffers.col_vbo_id =
+            rlLoadVertexBuffer(NULL, static_cast<int>(Point::col_vertex_size * buffers.capacity), true);
 
-        auto mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
-        auto total_offset = pos_offset + offset;
-        SetShaderValueMatrix(shader, GetShaderLocation(shader, "mvp"), mvp);
-        SetShaderValue(shader, GetShaderLocation(shader, "offset"), &total_offset, SHADER_UNIFORM_VEC3);
+        rlEnableVertexArray(buffers.vao_id);
 
-        glUniform1i(glGetUniformLocation(shader.id, "circle"), 0);
+        rlEnableVertexBuffer(buffers.pos_vbo_id);
+        rlEnableVertexAttribute(0);
+        rlSetVertexAttribute(0, 3, RL_FLOAT, false, Point::pos_vertex_size, 0);
+
+        rlEnableVertexBuffer(buffers.size_vbo_id);
+        rlEnableVertexAttribute(1);
+        rlSetVertexAttribute(1, 1, RL_FLOAT, false, Point::size_vertex_size, 0);
+
+        rlEnableVertexBuffer(buffers.col_vbo_id);
+        rlEnableVertexAttribute(2);
+        rlSetVertexAttribute(2, 4, RL_UNSIGNED_BYTE, true, Point::col_vertex_size, 0);
+
+        rlDisableVertexArray();
+        rlDisableVertexBuffer();
+
+        return buffers;
+    }
+
+    void release(Buffers buffers) {
+        pool.emplace_back(buffers);
+    }
+
+    void batch(const Particles& particles, Vector3 pos_offset) {
+        auto start = batched.size();
+        batched.resize(start + particles.alive_count);
+
+        for (std::size_t i = 0; i < particles.alive_count; i++) {
+            batched[start + i] = Vertex{
+                .pos = particles.pos[i] + pos_offset,
+                .size = particles.size[i],
+                .color = particles.color[i],
+            };
+        }
+    }
+
+    void flush(std::span<const Vector3> offsets) {
+        if (batched.empty()) return;
+
+        if (batched.size() > batch_capacity) {
+            if (batch_vao_id != 0) {
+                rlUnloadVertexArray(batch_vao_id);
+                rlUnloadVertexBuffer(batch_vbo_id);
+            }
+
+            batch_capacity = std::bit_ceil(batched.size());
+            batch_vao_id = rlLoadVertexArray();
+            batch_vbo_id = rlLoadVertexBuffer(NULL, static_cast<int>(sizeof(Vertex) * batch_capacity), true);
+
+            rlEnableVertexArray(batch_vao_id);
+            rlEnableVertexBuffer(batch_vbo_id);
+            rlEnableVertexAttribute(0);
+            rlSetVertexAttribute(0, 3, RL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, pos));
+            rlEnableVertexAttribute(1);
+            rlSetVertexAttribute(1, 1, RL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, size));
+            rlEnableVertexAttribute(2);
+            rlSetVertexAttribute(2, 4, RL_UNSIGNED_BYTE, true, sizeof(Vertex), offsetof(Vertex, color));
+            rlDisableVertexArray();
+            rlDisableVertexBuffer();
+        }
+        orphan_and_upload(batch_vbo_id, sizeof(Vertex) * batch_capacity, batched.data(),
+                          sizeof(Vertex) * batched.size());
+
+        BeginBlendMode(BLEND_ALPHA);
+
+        const auto& prog = program();
+        auto mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+        auto no_offset = Vector3Zero();
+        SetShaderValueMatrix(prog.shader, prog.mvp_loc, mvp);
+        SetShaderValue(prog.shader, prog.offset_loc, &no_offset, SHADER_UNIFORM_VEC3);
 
         glDepthMask(GL_FALSE);
         glEnable(GL_PROGRAM_POINT_SIZE);
-        glUseProgram(shader.id);
+        glUseProgram(prog.shader.id);
+        glUniform1i(prog.circle_loc, 0);
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, particle_circle.id);
+        glBindTexture(GL_TEXTURE_2D, circle().id);
 
-        rlEnableVertexArray(vao_id);
-        glDrawArrays(GL_POINTS, 0, static_cast<int>(particles.alive_count));
+        rlEnableVertexArray(batch_vao_id);
+        for (std::size_t i = 0; i < offsets.size(); i += Program::max_offsets) {
+            auto count = std::min(Program::max_offsets, offsets.size() - i);
+
+            rlSetUniform(prog.offsets_loc, offsets.data() + i, SHADER_UNIFORM_VEC3, static_cast<int>(count));
+            glDrawArraysInstanced(GL_POINTS, 0, static_cast<int>(batched.size()), static_cast<int>(count));
+        }
         rlDisableVertexArray();
 
         glUseProgram(rlGetShaderIdDefault());
@@ -293,48 +521,89 @@ namespace particle_system::renderers {
         glDepthMask(GL_TRUE);
 
         EndBlendMode();
+
+        batched.clear();
     }
 
-    void Point::setup_gl() {
-        vao_id = rlLoadVertexArray();
-        pos_vbo_id = rlLoadVertexBuffer(NULL, static_cast<int>(pos_vertex_size * max_size), true);
-        size_vbo_id = rlLoadVertexBuffer(NULL, static_cast<int>(size_vertex_size * max_size), true);
-        col_vbo_id = rlLoadVertexBuffer(NULL, static_cast<int>(col_vertex_size * max_size), true);
-        shader = LoadShader("./assets/particles.vs.glsl", "./assets/particles.fs.glsl");
+    void unload() {
+        for (const auto& buffers : pool) {
+            rlUnloadVertexArray(buffers.vao_id);
+            rlUnloadVertexBuffer(buffers.pos_vbo_id);
+            rlUnloadVertexBuffer(buffers.size_vbo_id);
+            rlUnloadVertexBuffer(buffers.col_vbo_id);
+        }
+        pool.clear();
 
-        pos_vertex_data.reset(new uint8_t[max_size * pos_vertex_size]{});
-        size_vertex_data.reset(new uint8_t[max_size * size_vertex_size]{});
-        col_vertex_data.reset(new uint8_t[max_size * col_vertex_size]{});
+        if (batch_vao_id != 0) {
+            rlUnloadVertexArray(batch_vao_id);
+            rlUnloadVertexBuffer(batch_vbo_id);
+        }
+        batch_vao_id = 0;
+        batch_vbo_id = 0;
+        batch_capacity = 0;
+        batched.clear();
+        batched.shrink_to_fit();
 
-        rlEnableVertexArray(vao_id);
+        if (loaded_program) UnloadShader(loaded_program->shader);
+        loaded_program.reset();
+        if (loaded_circle) UnloadTexture(*loaded_circle);
+        loaded_circle.reset();
+    }
+}
 
-        rlEnableVertexBuffer(pos_vbo_id);
-        rlEnableVertexAttribute(0);
-        rlSetVertexAttribute(0, 3, RL_FLOAT, false, pos_vertex_size, 0);
+namespace particle_system::renderers {
+    Point::Point(std::size_t max_size, Vector3 pos_offset) : pos_offset(pos_offset), max_size(max_size) {
+    }
 
-        rlEnableVertexBuffer(size_vbo_id);
-        rlEnableVertexAttribute(1);
-        rlSetVertexAttribute(1, 1, RL_FLOAT, false, size_vertex_size, 0);
+    Point::~Point() {
+        if (buffers.vao_id != 0) shared::release(buffers);
+    }
 
-        rlEnableVertexBuffer(col_vbo_id);
-        rlEnableVertexAttribute(2);
-        rlSetVertexAttribute(2, 4, RL_UNSIGNED_BYTE, true, col_vertex_size, 0);
+    void Point::operator()(Particles& particles, Vector3 offset) {
+        if (particles.alive_count == 0) return;
+        if (buffers.vao_id == 0) buffers = shared::acquire(max_size);
+
+        BeginBlendMode(BLEND_ALPHA);
+
+        shared::upload(buffers, particles);
+
+        const auto& program = shared::program();
+        auto mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+        auto total_offset = pos_offset + offset;
+        auto no_offset = Vector3Zero();
+        SetShaderValueMatrix(program.shader, program.mvp_loc, mvp);
+        SetShaderValue(program.shader, program.offset_loc, &total_offset, SHADER_UNIFORM_VEC3);
+        // left over from the last batched draw otherwise
+        SetShaderValue(program.shader, program.offsets_loc, &no_offset, SHADER_UNIFORM_VEC3);
+
+        glDepthMask(GL_FALSE);
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        glUseProgram(program.shader.id);
+        glUniform1i(program.circle_loc, 0);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, shared::circle().id);
 
+        rlEnableVertexArray(buffers.vao_id);
+        glDrawArrays(GL_POINTS, 0, static_cast<int>(particles.alive_count));
         rlDisableVertexArray();
-        rlDisableVertexBuffer();
 
-        Image img = LoadImageFromMemory(".png", particle_circle_data, sizeof(particle_circle_data));
-        particle_circle = LoadTextureFromImage(img);
-        UnloadImage(img);
+        glUseProgram(rlGetShaderIdDefault());
+        rlDisableTexture();
+        glDisable(GL_PROGRAM_POINT_SIZE);
+        glDepthMask(GL_TRUE);
+
+        EndBlendMode();
     }
 }
 
 namespace particle_system {
     System::System(std::size_t max_particles, renderers::Renderer&& renderer)
-        : renderer(std::forward<renderers::Renderer>(renderer)), particles(max_particles) {
+        : renderer(std::forward<renderers::Renderer>(renderer)), particles(max_particles), rng(seeds()) {
     }
 
     bool System::update(float dt) {
+        auto outer_rng = std::exchange(current_rng, &rng);
         bool can_emit = true;
 
         for (auto& e : emitters) {
@@ -353,6 +622,8 @@ namespace particle_system {
                 u);
         }
 
+        current_rng = outer_rng;
+
         auto simulating = can_emit || particles.alive_count != 0;
         if (reset_on_done && !simulating) {
             reset(*reset_on_done);
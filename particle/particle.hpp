@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -10,6 +11,7 @@
 #include <random>
 #include <raylib.h>
 #include <raymath.h>
+#include <span>
 #include <vector>
 #include <variant>
 
@@ -17,6 +19,22 @@
 #include "rlgl.h"
 
 namespace particle_system {
+    // particle arrays come out of here instead of straight from the heap, blocks of dead systems get handed to the
+    // next system of the same size
+    namespace storage {
+        // every array in a block starts on a boundary this big, enough for any simd load
+        constexpr std::size_t alignment = 64;
+
+        std::byte* acquire(std::size_t bytes);
+        void release(std::byte* block, std::size_t bytes);
+        // frees every block that isn't in use
+        void trim();
+    }
+
+    // reseeds what every new system's rng gets seeded from, it starts out seeded from the clock
+    void seed(std::uint64_t seed);
+
+    // all arrays live in one block from `storage`
     struct Particles {
         Vector3* pos;
         Vector3* velocity;
@@ -29,11 +47,14 @@ namespace particle_system {
         std::size_t max_size;
         std::size_t alive_count;
 
+        std::byte* block;
+        std::size_t block_size;
+
         Particles(std::size_t max_particles);
         Particles(const Particles&) = delete;
         Particles& operator=(const Particles&) = delete;
-        Particles(Particles&&);
-        Particles& operator=(Particles&&) noexcept = default;
+        Particles(Particles&&) noexcept;
+        Particles& operator=(Particles&&) noexcept;
         ~Particles();
 
         void kill(std::size_t ix);
@@ -202,12 +223,17 @@ namespace particle_system {
     }
 
     namespace updaters {
+        // the ranged `update`s only touch [begin, end) and are what `pipeline::Updaters` runs chunk by chunk
         struct Lifetime {
             void update(Particles& particles, float dt);
+            // only ages them, `finish` is what gets rid of the dead ones
+            void update(Particles& particles, float dt, std::size_t begin, std::size_t end);
+            void finish(Particles& particles);
         };
 
         struct Position {
             void update(Particles& particles, float dt);
+            void update(Particles& particles, float dt, std::size_t begin, std::size_t end);
         };
 
         struct ColorByVelocity {
@@ -219,6 +245,7 @@ namespace particle_system {
             ColorByVelocity(Color start, Color end, float min_threshold, float max_threshold);
 
             void update(Particles& particles, float dt);
+            void update(Particles& particles, float dt, std::size_t begin, std::size_t end);
         };
 
         using AnonUpdater = std::function<void(Particles& particles, float dt)>;
@@ -226,6 +253,52 @@ namespace particle_system {
     }
 
     namespace renderers {
+        // gl objects every `Point` shares, the shader and the texture get loaded once and the buffers go back into a
+        // pool when a renderer dies, so creating a system doesn't touch the disk or compile anything
+        namespace shared {
+            struct Buffers {
+                unsigned int vao_id = 0;
+                unsigned int pos_vbo_id = 0;
+                unsigned int size_vbo_id = 0;
+                unsigned int col_vbo_id = 0;
+                // in particles
+                std::size_t capacity = 0;
+            };
+
+            struct Program {
+                // how many tile offsets one instanced draw can take, see particles.vs.glsl
+                static constexpr std::size_t max_offsets = 4;
+
+                Shader shader;
+                int mvp_loc;
+                int offset_loc;
+                int offsets_loc;
+                int circle_loc;
+            };
+
+            // one particle of the batch, interleaved so the whole batch is a single buffer
+            struct Vertex {
+                Vector3 pos;
+                float size;
+                Color color;
+            };
+
+            const Program& program();
+            Texture2D circle();
+
+            // the smallest pooled buffers holding at least `capacity` particles, new ones if none are free
+            Buffers acquire(std::size_t capacity);
+            void release(Buffers buffers);
+
+            // adds the alive particles of a system to what gets drawn by the next `flush`
+            void batch(const Particles& particles, Vector3 pos_offset = Vector3Zero());
+            // draws everything batched since the last call, once per offset, with one instanced draw call
+            void flush(std::span<const Vector3> offsets);
+
+            // frees everything, has to happen before the window closes
+            void unload();
+        }
+
         struct Point {
             static constexpr std::size_t pos_vertex_size = 3 * sizeof(float);
             static constexpr std::size_t size_vertex_size = sizeof(float);
@@ -233,52 +306,24 @@ namespace particle_system {
 
             Vector3 pos_offset = Vector3Zero();
 
-            Texture2D particle_circle;
-
             std::size_t max_size;
-            std::unique_ptr<uint8_t[]> pos_vertex_data;
-            std::unique_ptr<uint8_t[]> size_vertex_data;
-            std::unique_ptr<uint8_t[]> col_vertex_data;
-            unsigned int vao_id = 0;
-            unsigned int pos_vbo_id = 0;
-            unsigned int size_vbo_id = 0;
-            unsigned int col_vbo_id = 0;
-            Shader shader;
+            // only taken from the pool once the renderer draws on its own, batched systems never need them
+            shared::Buffers buffers;
 
             Point(std::size_t max_size, Vector3 pos_offset = Vector3Zero());
             Point(const Point&) = delete;
             Point& operator=(const Point&) = delete;
-            Point(Point&& p) noexcept
-                : pos_offset(p.pos_offset), particle_circle(p.particle_circle), max_size(p.max_size),
-                  pos_vertex_data(std::move(p.pos_vertex_data)), size_vertex_data(std::move(p.size_vertex_data)),
-                  col_vertex_data(std::move(p.col_vertex_data)), vao_id(p.vao_id), pos_vbo_id(p.pos_vbo_id),
-                  size_vbo_id(p.size_vbo_id), col_vbo_id(p.col_vbo_id), shader(p.shader) {
-                p.particle_circle.id = 0;
-                p.vao_id = 0;
-                p.pos_vbo_id = 0;
-                p.size_vbo_id = 0;
-                p.col_vbo_id = 0;
-                p.shader.id = 0;
+            Point(Point&& p) noexcept : pos_offset(p.pos_offset), max_size(p.max_size), buffers(p.buffers) {
+                p.buffers = {};
             };
             Point& operator=(Point&& p) noexcept {
                 if (this != &p) {
+                    if (buffers.vao_id != 0) shared::release(buffers);
+
                     pos_offset = p.pos_offset;
-                    particle_circle = p.particle_circle;
                     max_size = p.max_size;
-                    pos_vertex_data = std::move(p.pos_vertex_data);
-                    size_vertex_data = std::move(p.size_vertex_data);
-                    col_vertex_data = std::move(p.col_vertex_data);
-                    vao_id = p.vao_id;
-                    pos_vbo_id = p.pos_vbo_id;
-                    size_vbo_id = p.size_vbo_id;
-                    col_vbo_id = p.col_vbo_id;
-                    shader = p.shader;
-                    p.particle_circle.id = 0;
-                    p.vao_id = 0;
-                    p.pos_vbo_id = 0;
-                    p.size_vbo_id = 0;
-                    p.col_vbo_id = 0;
-                    p.shader.id = 0;
+                    buffers = p.buffers;
+                    p.buffers = {};
                 }
 
                 return *this;
@@ -286,7 +331,6 @@ namespace particle_system {
             ~Point();
 
             void operator()(Particles& particles, Vector3 offset = Vector3Zero());
-            void setup_gl();
         };
 
         using AnonRenderer = std::function<void(Particles& particles, Vector3 offset)>;
@@ -300,6 +344,8 @@ namespace particle_system {
         renderers::Renderer renderer;
 
         Particles particles;
+        // what the generators draw from while this system updates
+        std::mt19937 rng;
 
         System(std::size_t max_particles, renderers::Renderer&& renderer);
         System(const System&) = delete;
@@ -308,6 +354,7 @@ namespace particle_system {
         System& operator=(System&& s) noexcept = default;
 
         // false - simulation ended
+        // only touches this system, so different systems can update on different threads at the same time
         bool update(float dt);
         void draw(Vector3 offset = Vector3Zero());
         void reset();
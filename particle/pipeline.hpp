@@ -0,0 +1,80 @@
+#pragma once
+
+#include "particle.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+
+// generators and updaters put together at compile time
+// a `CustomEmitter` or `System` goes through a variant and usually a `std::function` for every stage, and every stage
+// is its own pass over all the particles
+// a pipeline is one callable, it walks the particles once in chunks and runs every stage over a chunk before moving
+// on, so a chunk gets pulled into cache once instead of once per stage and the stages get inlined into each other
+// it still goes into a system as a single `AnonGen`/`AnonUpdater`, systems built at runtime keep working as they did
+namespace particle_system::pipeline {
+    // small enough that everything a chunk touches stays in L1
+    constexpr std::size_t chunk_size = 512;
+
+    namespace detail {
+        template <typename Gen>
+        void generate(Gen& gen, Particles& particles, float dt, std::size_t begin, std::size_t end) {
+            if constexpr (requires { gen.gen(particles, dt, begin, end); }) {
+                gen.gen(particles, dt, begin, end);
+            } else {
+                gen(particles, dt, begin, end);
+            }
+        }
+
+        template <typename Updater>
+        void update(Updater& updater, Particles& particles, float dt, std::size_t begin, std::size_t end) {
+            if constexpr (requires { updater.update(particles, dt, begin, end); }) {
+                updater.update(particles, dt, begin, end);
+            } else {
+                updater(particles, dt, begin, end);
+            }
+        }
+
+        template <typename Updater> void finish(Updater& updater, Particles& particles) {
+            if constexpr (requires { updater.finish(particles); }) {
+                updater.finish(particles);
+            }
+        }
+    }
+
+    // stages are anything from `generators` or a callable taking (particles, dt, start_ix, end_ix)
+    template <typename... Gens> struct Generators {
+        std::tuple<Gens...> stages;
+
+        explicit Generators(Gens... gens) : stages(std::move(gens)...) {
+        }
+
+        void operator()(Particles& particles, float dt, std::size_t start_ix, std::size_t end_ix) {
+            for (std::size_t begin = start_ix; begin < end_ix; begin += chunk_size) {
+                auto end = std::min(begin + chunk_size, end_ix);
+
+                std::apply([&](auto&... gens) { (detail::generate(gens, particles, dt, begin, end), ...); }, stages);
+            }
+        }
+    };
+
+    // stages are `updaters::Lifetime`, `Position`, `ColorByVelocity` or a callable taking (particles, dt, begin, end)
+    // a stage only ever sees its own chunk, so killing particles has to wait for `finish`, which every stage that has
+    // one gets once all the chunks are done
+    template <typename... Stages> struct Updaters {
+        std::tuple<Stages...> stages;
+
+        explicit Updaters(Stages... updaters) : stages(std::move(updaters)...) {
+        }
+
+        void operator()(Particles& particles, float dt) {
+            for (std::size_t begin = 0; begin < particles.alive_count; begin += chunk_size) {
+                auto end = std::min(begin + chunk_size, particles.alive_count);
+
+                std::apply([&](auto&... updaters) { (detail::update(updaters, particles, dt, begin, end), ...); },
+                           stages);
+            }
+
+            std::apply([&](auto&... updaters) { (detail::finish(updaters, particles), ...); }, stages);
+        }
+    };
+}
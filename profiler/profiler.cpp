@@ -0,0 +1,234 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point epoch = Clock::now();
+
+    std::atomic<bool> on = false;
+    // only true while enabled, so a disabled zone doesn't have to look at anything else
+    std::atomic<bool> in_frame = false;
+
+    std::atomic<uint32_t> next_thread = 0;
+    thread_local uint32_t thread_id = next_thread++;
+    thread_local uint16_t depth = 0;
+
+    // guards `current`, zones can end on any thread
+    std::mutex mutex;
+    profiler::Frame current;
+    uint64_t next_frame = 0;
+
+    // fills up to `history_size`, after that `oldest` moves around
+    std::vector<profiler::Frame> history;
+    std::size_t oldest = 0;
+
+    int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+    }
+
+    double to_ms(int64_t ns) {
+        return static_cast<double>(ns) / 1'000'000.0;
+    }
+
+    // same name, same color, every frame
+    Color zone_color(const char* name) {
+        auto hash = std::hash<std::string_view>{}(name);
+        return ColorFromHSV(static_cast<float>(hash % 360), 0.55f, 0.85f);
+    }
+}
+
+namespace profiler {
+    void enable(bool state) {
+        on = state;
+    }
+
+    bool enabled() {
+        return on;
+    }
+
+    void begin_frame() {
+        if (!on) return;
+
+        std::lock_guard lock(mutex);
+        current.index = next_frame++;
+        current.start = now();
+        current.thread = thread_id;
+        current.zones.clear();
+        in_frame = true;
+    }
+
+    void end_frame() {
+        if (!in_frame) return;
+
+        std::lock_guard lock(mutex);
+        in_frame = false;
+        current.end = now();
+
+        if (history.size() < history_size) {
+            history.emplace_back(std::move(current));
+            current = {};
+        } else {
+            // the oldest frame's zones get reused by the next one, so a full history doesn't allocate
+            std::swap(history[oldest], current);
+            oldest = (oldest + 1) % history_size;
+        }
+    }
+
+    std::size_t frame_count() {
+        return history.size();
+    }
+
+    const Frame& frame(std::size_t ix) {
+        return history[(oldest + ix) % history.size()];
+    }
+
+    void clear() {
+        std::lock_guard lock(mutex);
+        history.clear();
+        oldest = 0;
+    }
+
+    void export_chrome_trace(std::ostream& out) {
+        bool first = true;
+        auto event = [&](const char* name, uint32_t thread, int64_t start, int64_t end) {
+            // trace timestamps are in microseconds
+            out << std::format("{}\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                               first ? "" : ",", name, thread, static_cast<double>(start) / 1000.0,
+                               static_cast<double>(end - start) / 1000.0);
+            first = false;
+        };
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (std::size_t i = 0; i < frame_count(); i++) {
+            const auto& f = frame(i);
+
+            event("frame", f.thread, f.start, f.end);
+            for (const auto& zone : f.zones) {
+                event(zone.name, zone.thread, zone.start, zone.end);
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    bool export_chrome_trace(const char* path) {
+        std::ofstream file(path);
+        export_chrome_trace(file);
+
+        return static_cast<bool>(file);
+    }
+
+    void draw_overlay(Vector2 screen) {
+        if (history.empty()) return;
+
+        constexpr float width = 480.0f;
+        constexpr float graph_height = 80.0f;
+        constexpr float row_height = 14.0f;
+        constexpr float padding = 10.0f;
+        constexpr int font_size = 10;
+        // bars past this are cut off, anything this slow is red anyway
+        constexpr double graph_ms = 1000.0 / 30.0;
+        constexpr double budget_ms = 1000.0 / 60.0;
+        constexpr std::size_t max_depth = 8;
+        constexpr std::size_t listed_zones = 8;
+
+        const auto& last = frame(frame_count() - 1);
+
+        auto x = screen.x - width - padding;
+        auto y = 40.0f;
+        auto height = graph_height + padding + static_cast<float>(max_depth + listed_zones) * row_height + padding;
+        DrawRectangleRec({x - padding, y - padding, width + 2 * padding, height + 2 * padding}, Fade(BLACK, 0.7f));
+
+        // frame times, oldest on the left
+        double worst = 0.0;
+        auto bar_width = width / static_cast<float>(history_size);
+        for (std::size_t i = 0; i < frame_count(); i++) {
+            auto ms = to_ms(frame(i).end - frame(i).start);
+            worst = std::max(worst, ms);
+
+            auto bar_height = static_cast<float>(std::min(ms / graph_ms, 1.0)) * graph_height;
+            auto color = ms <= budget_ms ? GREEN : (ms <= graph_ms ? YELLOW : RED);
+            DrawRectangleRec({x + static_cast<float>(i) * bar_width, y + graph_height - bar_height, bar_width,
+                              bar_height},
+                             color);
+        }
+        auto budget_y = y + graph_height - static_cast<float>(budget_ms / graph_ms) * graph_height;
+        DrawLineV({x, budget_y}, {x + width, budget_y}, WHITE);
+        DrawText(std::format("frame {:.2f} ms, worst {:.2f} ms", to_ms(last.end - last.start), worst).c_str(),
+                 static_cast<int>(x), static_cast<int>(y), font_size, WHITE);
+
+        // flame graph of the last frame, only the thread that ran it, one row per depth
+        auto flame_y = y + graph_height + padding;
+        auto scale = width / static_cast<float>(std::max<int64_t>(last.end - last.start, 1));
+        for (const auto& zone : last.zones) {
+            if (zone.thread != last.thread || zone.depth >= max_depth) continue;
+
+            auto rec = Rectangle{
+                .x = x + static_cast<float>(zone.start - last.start) * scale,
+                .y = flame_y + static_cast<float>(zone.depth) * row_height,
+                .width = std::max(static_cast<float>(zone.end - zone.start) * scale, 1.0f),
+                .height = row_height - 1.0f,
+            };
+            DrawRectangleRec(rec, zone_color(zone.name));
+            if (static_cast<float>(MeasureText(zone.name, font_size)) + 4.0f < rec.width) {
+                DrawText(zone.name, static_cast<int>(rec.x) + 2, static_cast<int>(rec.y) + 2, font_size, BLACK);
+            }
+        }
+
+        // where the last frame went, summed up by name over every thread, slowest first
+        std::vector<std::pair<const char*, int64_t>> totals;
+        for (const auto& zone : last.zones) {
+            auto it = std::ranges::find_if(totals, [&](const auto& t) { return std::strcmp(t.first, zone.name) == 0; });
+            if (it == totals.end()) {
+                totals.emplace_back(zone.name, zone.end - zone.start);
+            } else {
+                it->second += zone.end - zone.start;
+            }
+        }
+        std::ranges::sort(totals, std::greater{}, &std::pair<const char*, int64_t>::second);
+
+        auto list_y = flame_y + static_cast<float>(max_depth) * row_height + padding;
+        for (std::size_t i = 0; i < std::min(totals.size(), listed_zones); i++) {
+            const auto& [name, ns] = totals[i];
+            auto row_y = static_cast<int>(list_y + static_cast<float>(i) * row_height);
+
+            DrawRectangle(static_cast<int>(x), row_y, font_size, font_size, zone_color(name));
+            DrawText(std::format("{} {:.3f} ms", name, to_ms(ns)).c_str(), static_cast<int>(x) + font_size + 4, row_y,
+                     font_size, WHITE);
+        }
+    }
+
+    Scope::Scope(const char* zone_name) : name(zone_name) {
+        if (!in_frame.load(std::memory_order_relaxed)) return;
+
+        start = now();
+        depth++;
+    }
+
+    Scope::~Scope() {
+        if (start < 0) return;
+
+        depth--;
+        auto end = now();
+
+        std::lock_guard lock(mutex);
+        // the frame might have ended in the meantime
+        if (!in_frame) return;
+        current.zones.emplace_back(Zone{
+            .name = name,
+            .start = start,
+            .end = end,
+            .thread = thread_id,
+            .depth = depth,
+        });
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <raylib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// where the time of a frame goes, zones are marked with `Scope` and every frame between `begin_frame` and
+// `end_frame` ends up in a short history
+// it's always compiled in, while disabled a zone costs one atomic load
+namespace profiler {
+    struct Zone {
+        // has to outlive the profiler, in practice a string literal
+        const char* name;
+        // nanoseconds since the profiler started
+        int64_t start;
+        int64_t end;
+        // small number given to every thread the first time it records something
+        uint32_t thread;
+        // how many zones of the same thread it's nested in
+        uint16_t depth;
+    };
+
+    struct Frame {
+        uint64_t index;
+        int64_t start;
+        int64_t end;
+        // thread that called `begin_frame`
+        uint32_t thread;
+        // ordered by when they ended
+        std::vector<Zone> zones;
+    };
+
+    // frames kept for the overlay and the export, about 4 seconds at 60 fps
+    inline constexpr std::size_t history_size = 240;
+
+    // starts out disabled, nothing is recorded until this gets turned on
+    void enable(bool state);
+    bool enabled();
+
+    // zones only get recorded between these two, on any thread
+    void begin_frame();
+    void end_frame();
+
+    // everything below is only safe on the thread calling `end_frame`
+
+    std::size_t frame_count();
+    // 0 is the oldest one
+    const Frame& frame(std::size_t ix);
+    void clear();
+
+    // the whole history in chrome's trace event format, for chrome://tracing or perfetto
+    void export_chrome_trace(std::ostream& out);
+    // false if the file couldn't be written
+    bool export_chrome_trace(const char* path);
+
+    // frame times of the whole history and a flame graph of the last frame, in the top right corner
+    void draw_overlay(Vector2 screen);
+
+    // a zone from construction to destruction
+    class Scope {
+      public:
+        explicit Scope(const char* zone_name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        const char* name;
+        int64_t start = -1;
+    };
+}
@@ -1,48 +1,52 @@
 #include "enemies.hpp"
 #include "hitbox.hpp"
+#include "jobs.hpp"
+#include "profiler.hpp"
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 #include "utility.hpp"
+#include <bit>
 #include <cassert>
-#include <memory>
 
 namespace enemies {
-    uint32_t Paladin::tick(QT<true>& enemies, std::size_t ix, const shapes::Circle target_hitbox) {
-        auto& data = enemies.data.vec[ix].val;
-
-        switch (data.collision_state) {
-            case Enemy::Collision:
-                data.anim_index = 0;
-                /*data.anim_curr_frame = 0;*/
-                data.movement = Vector2Zero();
-                return data.damage;
-            case Enemy::Uncollision:
-                data.anim_index = 1;
-                /*data.anim_curr_frame = 0;*/
-                data.update_target(enemies, target_hitbox.center, ix);
+    uint32_t Paladin::tick(EnemyPool& pool, ecs::Entity entity, [[maybe_unused]] const shapes::Circle target_hitbox) {
+        auto [collision_state, render, movement, damage] =
+            *pool.world.get<EnemyPool::CollisionState, EnemyPool::Render, enemy_movement, enemy_damage>(entity);
+
+        switch (collision_state) {
+            case EnemyPool::Collision:
+                render.anim_index = 0;
+                /*render.anim_curr_frame = 0;*/
+                movement = Vector2Zero();
+                return damage;
+            case EnemyPool::Uncollision:
+                // movement was already steered towards the target this tick
+                render.anim_index = 1;
+                /*render.anim_curr_frame = 0;*/
                 return 0;
-            case Enemy::Unchanged:
+            case EnemyPool::Unchanged:
                 return 0;
         }
     }
 
-    uint32_t Zombie::tick([[maybe_unused]] QT<true>& enemies, [[maybe_unused]] std::size_t ix,
+    uint32_t Zombie::tick([[maybe_unused]] EnemyPool& pool, [[maybe_unused]] ecs::Entity entity,
                           [[maybe_unused]] const shapes::Circle target_hitbox) {
         return 0;
     }
 
-    uint32_t Heraklios::tick([[maybe_unused]] QT<true>& enemies, [[maybe_unused]] std::size_t ix,
+    uint32_t Heraklios::tick([[maybe_unused]] EnemyPool& pool, [[maybe_unused]] ecs::Entity entity,
                              [[maybe_unused]] const shapes::Circle target_hitbox) {
         return 0;
     }
 
-    uint32_t Maw::tick([[maybe_unused]] QT<true>& enemies, [[maybe_unused]] std::size_t ix,
+    uint32_t Maw::tick([[maybe_unused]] EnemyPool& pool, [[maybe_unused]] ecs::Entity entity,
                        [[maybe_unused]] const shapes::Circle target_hitbox) {
         return 0;
     }
 
     std::optional<State> random_enemy(uint32_t available_cap, uint32_t& cap) {
-        int nth = GetRandomValue(1, static_cast<int>(_EnemyType::Size));
+        int nth = rng::value(rng::Stream::Spawner, 1, static_cast<int>(_EnemyType::Size));
         std::size_t i = 0, len = infos.size();
         bool exists_in_cap = false;
 
@@ -88,6 +92,7 @@ EnemyModels::EnemyModels() {
         model.transform = MatrixMultiply(model.transform, MatrixRotateX(static_cast<float>(std::numbers::pi) / 2.0f));
 
         models[i] = {model, anim};
+        bake(i);
     }
 }
 
@@ -95,44 +100,187 @@ std::pair<Model, EnemyModels::Animation> EnemyModels::operator[](const enemies::
     return models[static_cast<std::size_t>(enemies::get_type(state))];
 }
 
-std::vector<Matrix> EnemyModels::get_bone_transforms(const enemies::State& state) const {
-    auto [model, _] = (*this)[state];
+void EnemyModels::bake(std::size_t type) {
+    auto [model, animation] = models[type];
+    auto& batch = batches[type];
 
-    std::vector<Matrix> bones;
     for (int i = 0; i < model.meshCount; i++) {
-        bones.insert(bones.end(), model.meshes[i].boneMatrices,
-                     model.meshes[i].boneMatrices + model.meshes[i].boneCount);
+        batch.row_floats += 16 * static_cast<std::size_t>(model.meshes[i].boneCount);
     }
 
-    return bones;
+    for (int anim = 0; anim < animation.count; anim++) {
+        batch.first_rows.emplace_back(batch.pose_count());
+
+        for (int frame = 0; frame < animation.animations[anim].frameCount; frame++) {
+            // fills in the model's own bone matrices
+            UpdateModelAnimationBones(model, animation.animations[anim], frame);
+
+            for (int i = 0; i < model.meshCount; i++) {
+                const auto& mesh = model.meshes[i];
+                for (int bone = 0; bone < mesh.boneCount; bone++) {
+                    auto columns = MatrixToFloatV(mesh.boneMatrices[bone]);
+                    batch.palette.insert(batch.palette.end(), std::begin(columns.v), std::end(columns.v));
+                }
+            }
+        }
+    }
+}
+
+void EnemyModels::add_shader(Shader s) {
+    for (auto& [model, _] : models) {
+        for (int i = 0; i < model.materialCount; i++) {
+            model.materials[i].shader = s;
+        }
+    }
+
+    shader = s;
+    locations = Locations{
+        .view_projection = GetShaderLocation(shader, "viewProjection"),
+        .bone_palette = GetShaderLocation(shader, "bonePalette"),
+        .bone_offset = GetShaderLocation(shader, "boneOffset"),
+        .instance_transform = GetShaderLocationAttrib(shader, "instanceTransform"),
+        .instance_tint = GetShaderLocationAttrib(shader, "instanceTint"),
+        .instance_palette_row = GetShaderLocationAttrib(shader, "instancePaletteRow"),
+    };
+}
+
+void EnemyModels::push(const enemies::State& state, const Matrix& transform, Color tint, int anim_index,
+                       int anim_frame) {
+    auto type = static_cast<std::size_t>(enemies::get_type(state));
+    auto& batch = batches[type];
+    auto frame_count = models[type].second.animations[anim_index].frameCount;
+    auto pose = batch.first_rows[static_cast<std::size_t>(anim_index)] +
+                static_cast<std::size_t>(anim_frame % frame_count);
+
+    auto columns = MatrixToFloatV(transform);
+    batch.instances.insert(batch.instances.end(), std::begin(columns.v), std::end(columns.v));
+    batch.instances.insert(batch.instances.end(), {
+                                                      static_cast<float>(tint.r) / 255.0f,
+                                                      static_cast<float>(tint.g) / 255.0f,
+                                                      static_cast<float>(tint.b) / 255.0f,
+                                                      static_cast<float>(tint.a) / 255.0f,
+                                                      static_cast<float>(pose),
+                                                  });
 }
 
-void EnemyModels::update_bones(const enemies::State& state, std::vector<Matrix>& bone_transforms, int anim_index,
-                               int anim_frame) {
-    auto [model, animation] = (*this)[state];
+void EnemyModels::flush() {
+    profiler::Scope zone("EnemyModels::flush");
+
+    // whatever raylib has batched up so far goes first, the instanced draws below bypass it
+    rlDrawRenderBatchActive();
+
+    auto view_projection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    for (std::size_t i = 0; i < batches.size(); i++) {
+        auto& batch = batches[i];
+
+        if (batch.instance_count() != 0 && shader.id != 0) {
+            upload(batch);
+            draw(models[i].first, batch, view_projection);
+        }
 
-    auto mesh_bone_ptrs = std::unique_ptr<Matrix*[]>(new Matrix*[static_cast<unsigned int>(model.meshCount)]);
-    int sum = 0;
-    for (std::size_t i = 0; i < static_cast<std::size_t>(model.meshCount); i++) {
-        mesh_bone_ptrs[i] = model.meshes[i].boneMatrices;
+        batch.instances.clear();
+    }
+}
 
-        model.meshes[i].boneMatrices = bone_transforms.data() + sum;
-        sum += model.meshes[i].boneCount;
+void EnemyModels::upload(Batch& batch) {
+    // the palette never changes, it only has to get to the gpu once
+    if (batch.palette_texture == 0) {
+        batch.palette_texture =
+            rlLoadTexture(batch.palette.data(), static_cast<int>(batch.row_floats / 4),
+                          static_cast<int>(batch.pose_count()), PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
     }
 
-    UpdateModelAnimationBones(model, animation.animations[anim_index], anim_frame);
+    auto count = batch.instance_count();
+    if (count > batch.instance_capacity) {
+        if (batch.instance_vbo != 0) rlUnloadVertexBuffer(batch.instance_vbo);
 
-    for (std::size_t i = 0; i < static_cast<std::size_t>(model.meshCount); i++) {
-        model.meshes[i].boneMatrices = mesh_bone_ptrs[i];
+        batch.instance_capacity = std::bit_ceil(count);
+        batch.instance_vbo = rlLoadVertexBuffer(
+            nullptr, static_cast<int>(batch.instance_capacity * instance_floats * sizeof(float)), true);
     }
+    rlUpdateVertexBuffer(batch.instance_vbo, batch.instances.data(),
+                         static_cast<int>(batch.instances.size() * sizeof(float)), 0);
 }
 
-void EnemyModels::add_shader(Shader shader) {
-    for (auto& [model, _] : models) {
-        for (int i = 0; i < model.materialCount; i++) {
-            model.materials[i].shader = shader;
+void EnemyModels::draw(const Model& model, const Batch& batch, const Matrix& view_projection) {
+    constexpr int stride = static_cast<int>(instance_floats * sizeof(float));
+    auto count = static_cast<int>(batch.instance_count());
+
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(locations.view_projection, view_projection);
+
+    int palette_slot = 1;
+    rlActiveTextureSlot(palette_slot);
+    rlEnableTexture(batch.palette_texture);
+    rlSetUniform(locations.bone_palette, &palette_slot, SHADER_UNIFORM_INT, 1);
+
+    int bone_offset = 0;
+    for (int i = 0; i < model.meshCount; i++) {
+        const auto& mesh = model.meshes[i];
+        const auto& material = model.materials[model.meshMaterial[i]];
+
+        rlEnableVertexArray(mesh.vaoId);
+
+        // the mesh's own attributes are already set up in its vao, only the instance ones get added
+        rlEnableVertexBuffer(batch.instance_vbo);
+        for (int column = 0; column < 4; column++) {
+            auto loc = static_cast<unsigned int>(locations.instance_transform + column);
+            rlEnableVertexAttribute(loc);
+            rlSetVertexAttribute(loc, 4, RL_FLOAT, false, stride, column * 4 * static_cast<int>(sizeof(float)));
+            rlSetVertexAttributeDivisor(loc, 1);
+        }
+        rlEnableVertexAttribute(static_cast<unsigned int>(locations.instance_tint));
+        rlSetVertexAttribute(static_cast<unsigned int>(locations.instance_tint), 4, RL_FLOAT, false, stride,
+                             16 * static_cast<int>(sizeof(float)));
+        rlSetVertexAttributeDivisor(static_cast<unsigned int>(locations.instance_tint), 1);
+        rlEnableVertexAttribute(static_cast<unsigned int>(locations.instance_palette_row));
+        rlSetVertexAttribute(static_cast<unsigned int>(locations.instance_palette_row), 1, RL_FLOAT, false, stride,
+                             20 * static_cast<int>(sizeof(float)));
+        rlSetVertexAttributeDivisor(static_cast<unsigned int>(locations.instance_palette_row), 1);
+        rlDisableVertexBuffer();
+
+        // same as `DrawMesh`, meshes without colors read a constant white
+        if (mesh.colors == nullptr) {
+            float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            rlSetVertexAttributeDefault(shader.locs[SHADER_LOC_VERTEX_COLOR], white, SHADER_ATTRIB_VEC4, 4);
+        }
+
+        auto diffuse = material.maps[MATERIAL_MAP_DIFFUSE];
+        float color[4] = {
+            static_cast<float>(diffuse.color.r) / 255.0f,
+            static_cast<float>(diffuse.color.g) / 255.0f,
+            static_cast<float>(diffuse.color.b) / 255.0f,
+            static_cast<float>(diffuse.color.a) / 255.0f,
+        };
+        rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], color, SHADER_UNIFORM_VEC4, 1);
+
+        int diffuse_slot = 0;
+        rlActiveTextureSlot(diffuse_slot);
+        rlEnableTexture(diffuse.texture.id);
+        rlSetUniform(shader.locs[SHADER_LOC_MAP_DIFFUSE], &diffuse_slot, SHADER_UNIFORM_INT, 1);
+
+        rlSetUniform(locations.bone_offset, &bone_offset, SHADER_UNIFORM_INT, 1);
+        bone_offset += mesh.boneCount;
+
+        if (mesh.indices != nullptr) {
+            rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, nullptr, count);
+        } else {
+            rlDrawVertexArrayInstanced(0, mesh.vertexCount, count);
         }
+
+        rlDisableVertexAttribute(static_cast<unsigned int>(locations.instance_palette_row));
+        rlDisableVertexAttribute(static_cast<unsigned int>(locations.instance_tint));
+        for (int column = 0; column < 4; column++) {
+            rlDisableVertexAttribute(static_cast<unsigned int>(locations.instance_transform + column));
+        }
+        rlDisableVertexArray();
     }
+
+    rlActiveTextureSlot(palette_slot);
+    rlDisableTexture();
+    rlActiveTextureSlot(0);
+    rlDisableTexture();
+    rlDisableShader();
 }
 
 EnemyModels::~EnemyModels() {
@@ -140,192 +288,362 @@ EnemyModels::~EnemyModels() {
         UnloadModel(model);
         UnloadModelAnimations(animation.animations, animation.count);
     }
+
+    for (auto& batch : batches) {
+        if (batch.palette_texture != 0) rlUnloadTexture(batch.palette_texture);
+        if (batch.instance_vbo != 0) rlUnloadVertexBuffer(batch.instance_vbo);
+    }
 }
 
-void Enemy::update_bones(EnemyModels& enemy_models) {
-    enemy_models.update_bones(state, bone_transforms, anim_index, anim_curr_frame);
+HealthBars::HealthBars()
+    : shader(LoadShader("./assets/health_bar.vs.glsl", "./assets/health_bar.fs.glsl")),
+      view_projection_loc(GetShaderLocation(shader, "viewProjection")),
+      camera_right_loc(GetShaderLocation(shader, "cameraRight")),
+      camera_up_loc(GetShaderLocation(shader, "cameraUp")), size_loc(GetShaderLocation(shader, "size")),
+      health_color_loc(GetShaderLocation(shader, "healthColor")),
+      missing_color_loc(GetShaderLocation(shader, "missingColor")),
+      instance_bar_loc(GetShaderLocationAttrib(shader, "instanceBar")), vao(rlLoadVertexArray()) {
 }
 
-void Enemy::draw(Camera cam, EnemyModels& enemy_models, const Vector3& offset) {
-    auto [model, _] = enemy_models[state];
+void HealthBars::push(Vector3 position, float health) {
+    bars.insert(bars.end(), {position.x, position.y, position.z, health});
+}
 
-    auto mesh_bone_ptrs = std::unique_ptr<Matrix*[]>(new Matrix*[static_cast<unsigned int>(model.meshCount)]);
-    int sum = 0;
-    for (std::size_t i = 0; i < static_cast<std::size_t>(model.meshCount); i++) {
-        mesh_bone_ptrs[i] = model.meshes[i].boneMatrices;
+void HealthBars::flush() {
+    auto count = bars.size() / 4;
+    if (count == 0) return;
 
-        model.meshes[i].boneMatrices = bone_transforms.data() + sum;
-        sum += model.meshes[i].boneCount;
-    }
+    // whatever raylib has batched up so far goes first, the instanced draw below bypasses it
+    rlDrawRenderBatchActive();
 
-    DrawModelEx(model, Vector3Add(pos, offset), (Vector3){0.0f, 1.0f, 0.0f}, angle,
-                std::visit(
-                    [](auto&& arg) -> Vector3 {
-                        auto scale = std::decay_t<decltype(arg)>::info.model_scale;
-                        return (Vector3){scale, scale, scale};
-                    },
-                    state),
-                damage_tint_left == 0 ? WHITE : damage_tint);
-#ifdef DEBUG
-    simple_hitbox.draw_3D(RED, 1.0f, xz_component(offset));
-#endif
+    if (count > capacity) {
+        if (vbo != 0) rlUnloadVertexBuffer(vbo);
+
+        capacity = std::bit_ceil(count);
+        vbo = rlLoadVertexBuffer(nullptr, static_cast<int>(capacity * 4 * sizeof(float)), true);
 
-    for (std::size_t i = 0; i < static_cast<std::size_t>(model.meshCount); i++) {
-        model.meshes[i].boneMatrices = mesh_bone_ptrs[i];
+        // the corners come from `gl_VertexID`, so the bars are the only attribute
+        rlEnableVertexArray(vao);
+        rlEnableVertexBuffer(vbo);
+        rlEnableVertexAttribute(static_cast<unsigned int>(instance_bar_loc));
+        rlSetVertexAttribute(static_cast<unsigned int>(instance_bar_loc), 4, RL_FLOAT, false, 0, 0);
+        rlSetVertexAttributeDivisor(static_cast<unsigned int>(instance_bar_loc), 1);
+        rlDisableVertexArray();
+        rlDisableVertexBuffer();
     }
+    rlUpdateVertexBuffer(vbo, bars.data(), static_cast<int>(bars.size() * sizeof(float)), 0);
+
+    auto view = rlGetMatrixModelview();
+    Vector3 right = {view.m0, view.m4, view.m8};
+    Vector3 up = {view.m1, view.m5, view.m9};
+    auto health = ColorNormalize(health_color);
+    auto missing = ColorNormalize(missing_color);
+
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(view_projection_loc, MatrixMultiply(view, rlGetMatrixProjection()));
+    rlSetUniform(camera_right_loc, &right, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(camera_up_loc, &up, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(size_loc, &size, SHADER_UNIFORM_VEC2, 1);
+    rlSetUniform(health_color_loc, &health, SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(missing_color_loc, &missing, SHADER_UNIFORM_VEC4, 1);
+
+    rlDisableBackfaceCulling();
+    rlEnableVertexArray(vao);
+    rlDrawVertexArrayInstanced(0, 6, static_cast<int>(count));
+    rlDisableVertexArray();
+    rlEnableBackfaceCulling();
+    rlDisableShader();
+
+    bars.clear();
+}
 
-    // if (health == max_health) return;
-    //
-    // Vector2 dims = Vector2{
-    //     static_cast<float>(health_bar.texture.width),
-    //     static_cast<float>(health_bar.texture.height),
-    // };
-
-    // rlDisableBackfaceCulling();
-    // DrawBillboardCustom(cam, health_bar.texture,
-    //                     Rectangle{
-    //                         .x = 0.0f,
-    //                         .y = 0.0f,
-    //                         .width = dims.x,
-    //                         .height = dims.y,
-    //                     },
-    //                     Vector3{pos.x, pos.y + 50.0f, pos.z}, Vector3{0.0f, 1.0f, 0.0f}, dims,
-    //                     Vector2{dims.x / 2.0f, dims.y / 2.0f}, Vector3{3.0f, 0.0f, 0.0f}, WHITE);
-    // DrawBillboardCustom(cam, health_bar.texture,
-    //                     Rectangle{
-    //                         .x = 0.0f,
-    //                         .y = 0.0f,
-    //                         .width = dims.x,
-    //                         .height = dims.y,
-    //                     },
-    //                     Vector3{pos.x, pos.y + 50.0f, pos.z}, Vector3{0.0f, 1.0f, 0.0f}, dims,
-    //                     Vector2{dims.x / 2.0f, dims.y / 2.0f}, Vector3{3.0f, 180.0f, 0.0f}, WHITE);
-    // rlEnableBackfaceCulling();
+HealthBars::~HealthBars() {
+    if (vbo != 0) rlUnloadVertexBuffer(vbo);
+    rlUnloadVertexArray(vao);
+    UnloadShader(shader);
 }
 
-void Enemy::update_target(QT<true>& enemies, Vector2 player_pos, std::size_t ix) {
-    static const float neighbourhood_radius = 100.0f;
-    static constexpr float weight_attraction = 3.0f; // attraction to player
-    static constexpr float weight_separation = 5.0f;
+std::size_t EnemyPool::size() const {
+    return bodies.data->size();
+}
+
+ecs::Entity EnemyPool::insert(Vector2 position, uint16_t lvl, bool is_boss, enemies::State&& enemy) {
+    assert(lvl != 0);
+
+    auto info = get_info(enemy);
+    auto scale = 1 + lvl / 10;
 
-    auto id = enemies.data.vec[ix].id;
-    auto enemy_pos = enemies.data.vec[ix].val.position();
+    // TODO: scale based on `level`
+    auto [min_speed, max_speed] = info.speed_range;
+    std::uniform_int_distribution<uint16_t> speedDist(min_speed, max_speed);
+    auto speed = static_cast<float>(speedDist(rng::get(rng::Stream::Enemies)) * scale);
 
-    shapes::Circle circle_hitbox(enemy_pos, neighbourhood_radius);
+    auto [min_damage, max_damage] = info.damage_range;
+    std::uniform_int_distribution<uint32_t> damageDist(min_damage, max_damage);
+    auto damage = damageDist(rng::get(rng::Stream::Enemies)) * static_cast<uint32_t>(scale);
 
-    Vector2 attraction_force;
-    attraction_force.x = player_pos.x - enemy_pos.x;
-    attraction_force.y = player_pos.y - enemy_pos.y;
-    attraction_force.x = wrap((attraction_force.x + ARENA_WIDTH / 2.0f), ARENA_WIDTH) - ARENA_WIDTH / 2.0f;
-    attraction_force.y = wrap((attraction_force.y + ARENA_HEIGHT / 2.0f), ARENA_HEIGHT) - ARENA_HEIGHT / 2.0f;
-    if (Vector2LengthSqr(attraction_force) > 1e-6f) {
-        attraction_force = Vector2Normalize(attraction_force);
+    auto max_health = info.max_health * static_cast<uint32_t>(scale);
+
+    ecs::Entity entity;
+    if (free_entities.empty()) {
+        entity = world.new_entity();
+    } else {
+        entity = free_entities.back();
+        free_entities.pop_back();
     }
-    angle = std::fmod(270 - std::atan2(-attraction_force.y, -attraction_force.x) * 180.0f / std::numbers::pi_v<float>,
-                      360.0f);
 
-    Vector2 separation_force = Vector2Zero();
+    auto body = bodies.insert(position, info.simple_hitbox_radius, entity);
+    world.static_set_entity<Archetype>(entity, body, Vector2Zero(), position, speed, max_health, max_health, damage,
+                                       lvl, uint8_t{0}, is_boss, Uncollision, std::move(enemy),
+                                       Render{
+                                           .anim_index = info.default_anim,
+                                       });
 
-    enemies.search_by(
-        [&circle_hitbox](const auto& bbox) -> bool {
-            return check_collision(static_cast<Rectangle>(bbox), circle_hitbox);
-        },
-        [&circle_hitbox](const auto& enemy) -> bool { return check_collision(enemy.simple_hitbox, circle_hitbox); },
-        [&](const auto& e, auto e_ix) {
-            if (e_ix == ix || enemies.data.vec[e_ix].id == id) return;
+    return entity;
+}
 
-            auto d = enemy_pos - e.position();
+void EnemyPool::remove(std::size_t ix) {
+    auto entity = bodies.data.vec[ix].entity;
 
-            separation_force += Vector2Scale(Vector2Normalize(d), 1.0f / std::max(Vector2Length(d), 1e-6f));
-        });
-    /*for (const auto& [e_id, enemy] : enemies.data) {*/
-    /*    if (e_id == id) continue;*/
-    /**/
-    /*    auto d = enemy_pos - enemy.position();*/
-    /*    separation_force += Vector2Scale(Vector2Normalize(d), 1.0f / std::max(Vector2Length(d), 1e-6f));*/
-    /*}*/
-
-    movement = attraction_force * weight_attraction + separation_force * weight_separation;
-    movement +=
-        Vector2Scale(Vector2Normalize({GetRandomValue(-100, 100) / 100.f, GetRandomValue(-100, 100) / 100.f}), 0.1f);
-    movement = Vector2Normalize(movement);
+    bodies.remove(ix);
+    world.remove(entity);
+    free_entities.emplace_back(entity);
 }
 
-void Enemy::update_health_bar() {
-    BeginTextureMode(health_bar);
-    ClearBackground(RED);
-    EndTextureMode();
+uint32_t EnemyPool::tick(const shapes::Circle& target_hitbox) {
+    profiler::Scope zone("EnemyPool::tick");
+
+    world.make_system<enemy_damage_tint>().run([](uint8_t& tint) {
+        if (tint != 0) tint--;
+    });
+
+    integrate();
+
+    steer(target_hitbox.center);
+
+    update_collisions(target_hitbox);
+
+    uint32_t acc = 0;
+    world.make_system<enemies::State>().run<ecs::WithIDs>([&](ecs::Entity entity, enemies::State& state) {
+        acc += std::visit([&](auto&& arg) { return arg.tick(*this, entity, target_hitbox); }, state);
+    });
+
+    return acc;
 }
 
-uint32_t Enemy::tick(QT<true>& enemies, std::size_t ix, shapes::Circle target_hitbox, EnemyModels& enemy_models) {
-    return std::visit(
-        [&](auto&& arg) {
-            if (damage_tint_left != 0) damage_tint_left--;
+void EnemyPool::integrate() {
+    profiler::Scope zone("EnemyPool::integrate");
+
+    world.make_system<const quadtree::Handle, enemy_movement, enemy_prev_position, enemy_speed>().run(
+        [&](const quadtree::Handle& body, Vector2& movement, Vector2& prev_position, float& speed) {
+            auto ix = *bodies.data.lookup(body);
+            auto& pos = bodies.data.vec[ix].pos;
+
+            prev_position = pos;
+            pos.x += movement.x * speed;
+            pos.y += movement.y * speed;
+            arena::loop_around(pos.x, pos.y);
 
-            set_position({movement.x * speed, movement.y * speed});
-            update_target(enemies, target_hitbox.center, ix);
+            bodies.update(ix);
+        });
 
-            auto [_, animation] = enemy_models[state];
-            anim_curr_frame = (anim_curr_frame + 3) % animation.animations[anim_index].frameCount;
+    profiler::Scope maintain_zone("QuadTree::maintain");
+    bodies.maintain();
+}
 
+void EnemyPool::update_collisions(const shapes::Circle& target_hitbox) {
+    world.make_system<const quadtree::Handle, CollisionState>().run(
+        [&](const quadtree::Handle& body, CollisionState& cs) {
             // BUG: I don't think this is getting the right results, fix pwetty pwease
-            if (check_collision(target_hitbox, simple_hitbox)) {
-                switch (collision_state) {
-                    case Collision:
-                        collision_state = Unchanged;
-                        break;
-                    default:
-                        collision_state = Collision;
-                }
+            if (check_collision(target_hitbox, bodies.data[body].hitbox())) {
+                cs = cs == Collision ? Unchanged : Collision;
             } else {
-                switch (collision_state) {
-                    case Uncollision:
-                        collision_state = Unchanged;
-                        break;
-                    default:
-                        collision_state = Uncollision;
-                }
+                cs = cs == Uncollision ? Unchanged : Uncollision;
             }
+        });
+}
+
+void EnemyPool::animate(const enemies::State& state, Render& render, float distance, float delta_time,
+                        EnemyModels& enemy_models) {
+    if (render.animated_frame == frame) return;
+    render.animated_frame = frame;
+    render.anim_time += delta_time;
+
+    float interval = 0.0f;
+    for (const auto& [min_distance, lod_interval] : animation_lods) {
+        if (distance >= min_distance) interval = lod_interval;
+    }
+    if (render.anim_time < interval) return;
+
+    auto frames = static_cast<int>(render.anim_time * animation_fps);
+    if (frames == 0) return;
+    render.anim_time -= static_cast<float>(frames) / animation_fps;
+
+    auto [_, animation] = enemy_models[state];
+    render.anim_curr_frame = (render.anim_curr_frame + frames) % animation.animations[render.anim_index].frameCount;
+}
+
+void EnemyPool::steer(Vector2 target) {
+    profiler::Scope zone("EnemyPool::steer");
+
+    auto& xs = steering_scratch.xs;
+    auto& ys = steering_scratch.ys;
+    auto& entities = steering_scratch.entities;
+    auto& jitter = steering_scratch.jitter;
+    auto& movements = steering_scratch.movements;
+    auto& angles = steering_scratch.angles;
+
+    // systems visit entities in the same order every time, so the i-th entry belongs to the i-th entity of the commit
+    // down below
+    xs.clear();
+    ys.clear();
+    entities.clear();
+    jitter.clear();
+    world.make_system<const quadtree::Handle>().run<ecs::WithIDs>(
+        [&](ecs::Entity entity, const quadtree::Handle& body) {
+            auto pos = bodies.data[body].pos;
+            xs.emplace_back(pos.x);
+            ys.emplace_back(pos.y);
+            entities.emplace_back(entity);
+            // the stream isn't thread safe and the draws have to come in the same order every time, so this can't
+            // happen on the workers
+            auto jitter_x = static_cast<float>(rng::value(rng::Stream::Enemies, -100, 100)) / 100.f;
+            auto jitter_y = static_cast<float>(rng::value(rng::Stream::Enemies, -100, 100)) / 100.f;
+            jitter.emplace_back(Vector2Scale(Vector2Normalize({jitter_x, jitter_y}), 0.1f));
+        });
 
-            return arg.tick(enemies, ix, target_hitbox);
-        },
-        state);
+    auto n = xs.size();
+    movements.resize(n);
+    angles.resize(n);
+
+    // workers only read `bodies` and write their own slice of `movements` and `angles`
+    jobs::pool().parallel_for(n, steer_grain, [&](std::size_t begin, std::size_t end) {
+        thread_local std::vector<float> attraction_x, attraction_y, neighbour_xs, neighbour_ys;
+
+        auto count = end - begin;
+        attraction_x.resize(count);
+        attraction_y.resize(count);
+        steering::attraction(target, std::span(xs).subspan(begin, count), std::span(ys).subspan(begin, count),
+                             attraction_x, attraction_y, std::span(angles).subspan(begin, count));
+
+        for (auto i = begin; i < end; i++) {
+            auto separation_force = separation(entities[i], {xs[i], ys[i]}, neighbour_xs, neighbour_ys);
+
+            auto& movement = movements[i];
+            movement = Vector2{attraction_x[i - begin], attraction_y[i - begin]} * steering::weight_attraction +
+                       separation_force * steering::weight_separation;
+            movement += jitter[i];
+            movement = Vector2Normalize(movement);
+        }
+    });
+
+    std::size_t i = 0;
+    world.make_system<enemy_movement, Render>().run([&](Vector2& movement, Render& render) {
+        movement = movements[i];
+        render.angle = angles[i];
+        i++;
+    });
+}
+
+Vector2 EnemyPool::separation(ecs::Entity entity, Vector2 position, std::vector<float>& neighbour_xs,
+                              std::vector<float>& neighbour_ys) {
+    shapes::Circle neighbourhood(position, steering::neighbourhood_radius);
+
+    auto bounds = bounding_box(neighbourhood);
+    bounds.x -= enemies::max_hitbox_radius;
+    bounds.y -= enemies::max_hitbox_radius;
+    bounds.width += 2.0f * enemies::max_hitbox_radius;
+    bounds.height += 2.0f * enemies::max_hitbox_radius;
+
+    neighbour_xs.clear();
+    neighbour_ys.clear();
+    bodies.query(
+        bounds, [&neighbourhood](const auto& body) -> bool { return check_collision(body.hitbox(), neighbourhood); },
+        [&](const auto& body, auto) {
+            if (body.entity == entity) return;
+
+            neighbour_xs.emplace_back(body.pos.x);
+            neighbour_ys.emplace_back(body.pos.y);
+        });
+
+    return steering::separation(position, neighbour_xs, neighbour_ys);
 }
 
-std::optional<std::pair<uint32_t, uint64_t>> Enemy::take_damage(uint64_t taken_damage,
-                                                                [[maybe_unused]] Element element) {
+void EnemyPool::new_frame() {
+    frame++;
+}
+
+void EnemyPool::draw(ecs::Entity entity, Vector2 position, EnemyModels& enemy_models, HealthBars& health_bars,
+                     const Vector3& offset, const View& view) {
+    auto [state, render, tint, prev_position, health, max_health] =
+        *world.get<enemies::State, Render, enemy_damage_tint, enemy_prev_position, enemy_health, enemy_max_health>(
+            entity);
+    auto [model, _] = enemy_models[state];
+    auto info = enemies::get_info(state);
+
+    animate(state, render, Vector2Distance(position + xz_component(offset), view.center), view.delta_time,
+            enemy_models);
+
+    // back from the current position, so an enemy that just looped around the arena stays on this side of it
+    auto moved = position - prev_position;
+    if (moved.x > ARENA_WIDTH / 2.0f) moved.x -= ARENA_WIDTH;
+    if (moved.x < -ARENA_WIDTH / 2.0f) moved.x += ARENA_WIDTH;
+    if (moved.y > ARENA_HEIGHT / 2.0f) moved.y -= ARENA_HEIGHT;
+    if (moved.y < -ARENA_HEIGHT / 2.0f) moved.y += ARENA_HEIGHT;
+    auto interpolated = position - moved * (1.0f - view.interpolation);
+
+    // same transform `DrawModelEx` would build
+    Vector3 pos = Vector3Add({interpolated.x, info.y_component, interpolated.y}, offset);
+    auto transform = MatrixMultiply(MatrixMultiply(MatrixScale(info.model_scale, info.model_scale, info.model_scale),
+                                                   MatrixRotate({0.0f, 1.0f, 0.0f}, render.angle * DEG2RAD)),
+                                    MatrixTranslate(pos.x, pos.y, pos.z));
+
+    enemy_models.push(state, MatrixMultiply(model.transform, transform), tint == 0 ? WHITE : damage_tint,
+                      render.anim_index, render.anim_curr_frame);
+#ifdef DEBUG
+    shapes::Circle(interpolated, info.simple_hitbox_radius).draw_3D(RED, 1.0f, xz_component(offset));
+#endif
+
+
+    if (health != max_health) {
+        health_bars.push(Vector3Add(pos, {0.0f, HealthBars::height, 0.0f}),
+                         static_cast<float>(health) / static_cast<float>(max_health));
+    }
+}
+
+std::optional<std::pair<uint32_t, uint64_t>> EnemyPool::take_damage(ecs::Entity entity, uint64_t taken_damage,
+                                                                    [[maybe_unused]] Element element) {
+    auto [health, tint] = *world.get<enemy_health, enemy_damage_tint>(entity);
+
     // TODO: Elemental damage scaling
     if (health <= taken_damage) {
         health = 0;
-        return std::make_pair(dropped_exp(), dropped_souls());
+        return std::make_pair(dropped_exp(entity), dropped_souls(entity));
     }
 
-    damage_tint_left = damage_tint_init;
+    tint = damage_tint_init;
 
-    health -= damage;
+    health -= static_cast<uint32_t>(taken_damage);
     return std::nullopt;
 }
 
-Vector2 Enemy::position() const {
-    return xz_component(pos);
+Vector2 EnemyPool::position(std::size_t ix) const {
+    return bodies.data.vec[ix].pos;
 }
 
-void Enemy::set_position(const Vector2& p) {
-    pos.x += p.x;
-    pos.z += p.y;
-    arena::loop_around(pos.x, pos.z);
-
-    simple_hitbox.center.x = pos.x;
-    simple_hitbox.center.y = pos.z;
+shapes::Circle EnemyPool::hitbox(std::size_t ix) const {
+    return bodies.data.vec[ix].hitbox();
 }
 
-uint32_t Enemy::dropped_exp() const {
+uint32_t EnemyPool::dropped_exp(ecs::Entity entity) {
+    auto [state, level, boss] = *world.get<enemies::State, enemy_level, enemy_boss>(entity);
     auto info = enemies::get_info(state);
 
     return info.base_exp_dropped * level * (boss ? 10 : 1);
 }
 
-uint64_t Enemy::dropped_souls() const {
+uint64_t EnemyPool::dropped_souls(ecs::Entity entity) {
+    auto [state, level, boss] = *world.get<enemies::State, enemy_level, enemy_boss>(entity);
     auto info = enemies::get_info(state);
 
     return info.base_soul_dropped * level * (boss ? 10 : 1);
@@ -1,19 +1,51 @@
 #pragma once
 
+#include "ecs.hpp"
+#include "grid.hpp"
 #include "hitbox.hpp"
 #include "quadtree.hpp"
 #include "raylib.h"
 #include "raymath.h"
 #include "spell.hpp"
+#include "steering.hpp"
 #include "utility.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <random>
 #include <variant>
 
-struct Enemy;
+namespace enemies {
+    // the part of an enemy the spatial index works with, the rest is in `EnemyPool::world`
+    struct Body {
+        Vector2 pos;
+        float radius;
+        ecs::Entity entity;
+
+        Vector2 position() const {
+            return pos;
+        }
 
-template <bool Check> using QT = quadtree::QuadTree<10, Enemy, Check>;
+        void set_position(const Vector2& p) {
+            pos = p;
+        }
+
+        shapes::Circle hitbox() const {
+            return shapes::Circle(pos, radius);
+        }
+    };
+}
+
+#ifdef ENEMIES_GRID
+using QT = grid::Grid<enemies::Body>;
+#else
+using QT = quadtree::QuadTree<10, enemies::Body>;
+#endif
+
+static_assert(grid::Broadphase<QT, enemies::Body>);
+
+struct EnemyPool;
 
 namespace enemies {
     enum struct EnemyClass {
@@ -44,7 +76,7 @@ namespace enemies {
             Sprinting = 1,
         };
 
-        uint32_t tick(QT<true>& enemies, std::size_t ix, const shapes::Circle target_hitbox);
+        uint32_t tick(EnemyPool& pool, ecs::Entity entity, const shapes::Circle target_hitbox);
 
         static constexpr Info info = (Info){
             .model_path = "./assets/paladin.glb",
@@ -63,7 +95,7 @@ namespace enemies {
     };
 
     struct Zombie {
-        uint32_t tick(QT<true>& enemies, std::size_t ix, const shapes::Circle target_hitbox);
+        uint32_t tick(EnemyPool& pool, ecs::Entity entity, const shapes::Circle target_hitbox);
 
         static constexpr Info info = (Info){
             .model_path = "./assets/zombie.glb",
@@ -82,7 +114,7 @@ namespace enemies {
     };
 
     struct Heraklios {
-        uint32_t tick(QT<true>& enemies, std::size_t ix, const shapes::Circle target_hitbox);
+        uint32_t tick(EnemyPool& pool, ecs::Entity entity, const shapes::Circle target_hitbox);
 
         static constexpr Info info = (Info){
             .model_path = "./assets/heraklios.glb",
@@ -101,7 +133,7 @@ namespace enemies {
     };
 
     struct Maw {
-        uint32_t tick(QT<true>& enemies, std::size_t ix, const shapes::Circle target_hitbox);
+        uint32_t tick(EnemyPool& pool, ecs::Entity entity, const shapes::Circle target_hitbox);
 
         static constexpr Info info = (Info){
             .model_path = "./assets/maw.glb",
@@ -120,10 +152,10 @@ namespace enemies {
     };
 
     template <uint8_t N, typename T>
-    concept IsEnemy = requires(T e, std::size_t ix, const shapes::Circle& hitbox, QT<true>& enemies) {
+    concept IsEnemy = requires(T e, ecs::Entity entity, const shapes::Circle& hitbox, EnemyPool& pool) {
         { T::info } -> std::same_as<const Info&>;
         // gets called if target hitbox collides or uncollides with enemy hitbox
-        { e.tick(enemies, ix, hitbox) } -> std::same_as<uint32_t>;
+        { e.tick(pool, entity, hitbox) } -> std::same_as<uint32_t>;
     };
 
 #define EACH_ENEMY(F, G) G(Paladin) /* \ */
@@ -153,6 +185,13 @@ namespace enemies {
 #undef ENEMY_VARIANT
         >;
 
+    // how far an enemy's hitbox can reach outside of the quadtree node holding its center
+    constexpr float max_hitbox_radius = std::max({
+#define ENEMY_RADIUS(name) name::info.simple_hitbox_radius,
+        EACH_ENEMY(ENEMY_RADIUS, ENEMY_RADIUS)
+#undef ENEMY_RADIUS
+    });
+
     template <_EnemyType Type> struct EnemyFromEnum;
 
 #define TAG_SPECIALIZE(name)                                                                                           \
@@ -226,18 +265,115 @@ class EnemyModels {
 
     std::pair<Model, Animation> operator[](const enemies::State& state) const;
 
-    std::vector<Matrix> get_bone_transforms(const enemies::State& state) const;
-    void update_bones(const enemies::State& state, std::vector<Matrix>& bone_transforms, int anim_index,
-                      int anim_frame);
+    // has to be the instanced skinning shader, see assets/skinning.vs.glsl
     void add_shader(Shader shader);
 
+    // everything pushed during a frame gets drawn by `flush`, one instanced draw call per mesh of every enemy type
+    // the pose is looked up in the palette baked at load time, frames past the end of the animation wrap around
+    void push(const enemies::State& state, const Matrix& transform, Color tint, int anim_index, int anim_frame);
+    // has to be called between `BeginMode3D` and `EndMode3D`
+    void flush();
+
     ~EnemyModels();
 
   private:
+    // 16 floats of transform, 4 of tint and the palette row
+    static constexpr std::size_t instance_floats = 21;
+
+    // every pose of one enemy type and the instances waiting for `flush`
+    struct Batch {
+        // floats in one palette row, 16 per bone of every mesh
+        std::size_t row_floats = 0;
+        // one row for every frame of every animation, animation `i` starts at row `first_rows[i]`
+        std::vector<float> palette;
+        std::vector<std::size_t> first_rows;
+        std::vector<float> instances;
+
+        unsigned int palette_texture = 0;
+        unsigned int instance_vbo = 0;
+        std::size_t instance_capacity = 0;
+
+        std::size_t pose_count() const {
+            return row_floats == 0 ? 0 : palette.size() / row_floats;
+        }
+
+        std::size_t instance_count() const {
+            return instances.size() / instance_floats;
+        }
+    };
+
+    struct Locations {
+        int view_projection = -1;
+        int bone_palette = -1;
+        int bone_offset = -1;
+        int instance_transform = -1;
+        int instance_tint = -1;
+        int instance_palette_row = -1;
+    };
+
     std::array<std::pair<Model, Animation>, static_cast<int>(enemies::_EnemyType::Size)> models;
+    std::array<Batch, static_cast<int>(enemies::_EnemyType::Size)> batches;
+    Shader shader = {};
+    Locations locations;
+
+    // runs every animation of `models[type]` once and keeps the results in its palette
+    void bake(std::size_t type);
+    void upload(Batch& batch);
+    void draw(const Model& model, const Batch& batch, const Matrix& view_projection);
 };
 
-struct Enemy {
+// bars over every damaged enemy drawn this frame, `flush` draws all of them with one instanced call
+class HealthBars {
+  public:
+    static constexpr Vector2 size = {20.0f, 3.0f};
+    // how far above the enemy's model origin the bar floats
+    static constexpr float height = 25.0f;
+    static constexpr Color health_color = RED;
+    static constexpr Color missing_color = (Color){40, 40, 40, 255};
+
+    HealthBars();
+    HealthBars(const HealthBars&) = delete;
+    HealthBars& operator=(const HealthBars&) = delete;
+
+    // `health` goes from 0 to 1
+    void push(Vector3 position, float health);
+    // has to be called between `BeginMode3D` and `EndMode3D`
+    void flush();
+
+    ~HealthBars();
+
+  private:
+    // center of the bar and the health left, 4 floats per bar
+    std::vector<float> bars;
+
+    Shader shader;
+    int view_projection_loc;
+    int camera_right_loc;
+    int camera_up_loc;
+    int size_loc;
+    int health_color_loc;
+    int missing_color_loc;
+    int instance_bar_loc;
+
+    unsigned int vao = 0;
+    unsigned int vbo = 0;
+    std::size_t capacity = 0;
+};
+
+TAG_BY_NAME(Vector2, enemy_movement);
+// where the enemy was before the last tick, drawing interpolates from here
+TAG_BY_NAME(Vector2, enemy_prev_position);
+TAG_BY_NAME(float, enemy_speed);
+TAG_BY_NAME(uint32_t, enemy_health);
+TAG_BY_NAME(uint32_t, enemy_max_health);
+TAG_BY_NAME(uint32_t, enemy_damage);
+TAG_BY_NAME(uint16_t, enemy_level);
+TAG_BY_NAME(uint8_t, enemy_damage_tint);
+TAG_BY_NAME(bool, enemy_boss);
+
+// every enemy is an entity in `world`, its position lives in `bodies`
+// `quadtree::Handle` points from the entity to its body and `Body::entity` points back
+struct EnemyPool {
   public:
     static constexpr uint8_t damage_tint_init = 2;
     static constexpr Color damage_tint = (Color){200, 200, 200, 180};
@@ -248,71 +384,104 @@ struct Enemy {
         Unchanged,
     };
 
-    int anim_index = 0;
-    int anim_curr_frame = 0;
-
-    uint8_t damage_tint_left = 0;
-
-    uint32_t max_health;
-    uint32_t health;
-    uint32_t damage;
-    uint16_t speed;
-    uint16_t level;
-
-    Vector3 pos;
-    Vector2 movement;
-    float angle;
-    shapes::Circle simple_hitbox;
-    CollisionState collision_state = Uncollision;
-
-    // TODO: Stats are multiplied by some scaling factor and model is increased by 2x
-    bool boss;
-
-    enemies::State state;
-    std::vector<Matrix> bone_transforms;
-
-    RenderTexture2D health_bar = {};
-
-    Enemy(Vector2 position, uint16_t level, bool boss, enemies::State&& enemy, std::vector<Matrix> bone_transforms)
-        : anim_index(get_info(enemy).default_anim), level(level),
-          pos((Vector3){position.x, get_info(enemy).y_component, position.y}), movement(Vector2Zero()),
-          simple_hitbox(shapes::Circle(position, get_info(enemy).simple_hitbox_radius)), boss(boss), state(enemy),
-          bone_transforms(bone_transforms) {
-        assert(level != 0);
-
-        auto info = get_info(enemy);
-        max_health = health = info.max_health * (1 + level / 10);
+    // only needed for drawing, kept out of the way of the simulation columns
+    struct Render {
+        int anim_index = 0;
+        int anim_curr_frame = 0;
+        // time the animation hasn't caught up on yet
+        float anim_time = 0.0f;
+        // `EnemyPool::frame` of the last time the animation was advanced
+        uint32_t animated_frame = 0;
+        float angle = 0.0f;
+    };
 
-        // TODO: scale based on `level`
-        auto [min_speed, max_speed] = info.speed_range;
-        std::uniform_int_distribution<uint16_t> speedDist(min_speed, max_speed);
-        speed = speedDist(rng::get()) * (1 + level / 10);
+    // TODO: `enemy_boss` stats are multiplied by some scaling factor and model is increased by 2x
+    using Archetype =
+        ecs::Archetype<quadtree::Handle, enemy_movement, enemy_prev_position, enemy_speed, enemy_health,
+                       enemy_max_health, enemy_damage, enemy_level, enemy_damage_tint, enemy_boss, CollisionState,
+                       enemies::State, Render>;
 
-        auto [min_damage, max_damage] = info.damage_range;
-        std::uniform_int_distribution<uint32_t> damageDist(min_damage, max_damage);
-        damage = damageDist(rng::get()) * (1 + level / 10);
+    QT bodies;
+    ecs::build<Archetype> world;
+    // entities of dead enemies, handed out again before asking `world` for new ones
+    std::vector<ecs::Entity> free_entities;
 
-        health_bar = LoadRenderTexture(50, 10);
+    EnemyPool(quadtree::Box bbox, bool toroidal) : bodies(bbox, toroidal) {
     }
 
-    Enemy(const Enemy&) = delete;
-    Enemy& operator=(const Enemy&) = delete;
+    EnemyPool(const EnemyPool&) = delete;
+    EnemyPool& operator=(const EnemyPool&) = delete;
 
-    Enemy(Enemy&&) noexcept = default;
-    Enemy& operator=(Enemy&&) = default;
+    EnemyPool(EnemyPool&&) noexcept = default;
+    EnemyPool& operator=(EnemyPool&&) noexcept = default;
+
+    std::size_t size() const;
+    ecs::Entity insert(Vector2 position, uint16_t level, bool boss, enemies::State&& enemy);
+    // `ix` is the dense index in `bodies`, the last body gets swapped into it
+    void remove(std::size_t ix);
 
-    void update_bones(EnemyModels& enemy_models);
-    void draw(Camera cam, EnemyModels& enemy_models, const Vector3& offset);
-    void update_target(QT<true>& enemies, Vector2 player_pos, std::size_t ix);
-    void update_health_bar();
     // returned number is the amount of damage taken by the player
-    uint32_t tick(QT<true>& enemies, std::size_t ix, shapes::Circle target_hitbox, EnemyModels& enemy_models);
+    uint32_t tick(const shapes::Circle& target_hitbox);
+
+    // what every `draw` in a frame has in common
+    struct View {
+        // animations of enemies further away from here get updated less often
+        Vector2 center;
+        // how far along the frame is between the last tick and the next one, from 0 to 1
+        float interpolation;
+        // seconds since the last frame
+        float delta_time;
+    };
+
+    // has to be called before the first `draw` of every frame
+    void new_frame();
+    // only queues the enemy and its health bar up, they show up once `enemy_models` and `health_bars` get flushed
+    // the animation only moves on for enemies that get drawn, once per frame no matter how many offsets they show up at
+    void draw(ecs::Entity entity, Vector2 position, EnemyModels& enemy_models, HealthBars& health_bars,
+              const Vector3& offset, const View& view);
 
     // if not nullopt, then the enemy is dead and dropped uint32_t amount of exp and uint64_t amount of souls
-    std::optional<std::pair<uint32_t, uint64_t>> take_damage(uint64_t damage, Element element);
+    std::optional<std::pair<uint32_t, uint64_t>> take_damage(ecs::Entity entity, uint64_t damage, Element element);
 
-    Vector2 position() const;
-    void set_position(const Vector2& p);
-    uint32_t dropped_exp() const;
-    uint64_t dropped_souls() const;
+    Vector2 position(std::size_t ix) const;
+    shapes::Circle hitbox(std::size_t ix) const;
+    uint32_t dropped_exp(ecs::Entity entity);
+    uint64_t dropped_souls(ecs::Entity entity);
+
+  private:
+    // rate the models' animations were made for
+    static constexpr float animation_fps = 60.0f;
+    // how often the pose gets updated for enemies at least `first` away from the view center, closest first
+    static constexpr std::array<std::pair<float, float>, 3> animation_lods = {{
+        {0.0f, 0.0f},
+        {200.0f, 1.0f / 30.0f},
+        {350.0f, 1.0f / 15.0f},
+    }};
+
+    // chunks of enemies steered by one job
+    static constexpr std::size_t steer_grain = 64;
+
+    // reused every tick by `steer`, so it doesn't allocate once the arena is full
+    struct SteeringScratch {
+        std::vector<float> xs;
+        std::vector<float> ys;
+        std::vector<ecs::Entity> entities;
+        std::vector<Vector2> jitter;
+        std::vector<Vector2> movements;
+        std::vector<float> angles;
+    } steering_scratch;
+
+    // moves everyone along their movement, the spatial index is up to date afterwards
+    void integrate();
+    // new movement and facing angle for everyone, done in batches by `steering` spread over `jobs::pool`
+    void steer(Vector2 target);
+    // safe to call from several threads at once as long as nobody moves `bodies`
+    Vector2 separation(ecs::Entity entity, Vector2 position, std::vector<float>& neighbour_xs,
+                       std::vector<float>& neighbour_ys);
+    void update_collisions(const shapes::Circle& target_hitbox);
+    void animate(const enemies::State& state, Render& render, float distance, float delta_time,
+                 EnemyModels& enemy_models);
+
+    // counts calls to `new_frame`, starts at 1 so that fresh enemies haven't been animated yet
+    uint32_t frame = 1;
 };
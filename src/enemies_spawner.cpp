@@ -3,13 +3,14 @@
 #include "enemies.hpp"
 #include "hitbox.hpp"
 #include "player.hpp"
+#include "profiler.hpp"
 #include "utility.hpp"
 #include <cstdint>
 #include <random>
 #include <raylib.h>
 #include <raymath.h>
 
-bool Enemies::spawn(const EnemyModels& enemy_models, const Vector2& player_pos) {
+bool Enemies::spawn(const Vector2& player_pos) {
     static constexpr float arena_width = ARENA_WIDTH / 2.0f;
     static constexpr float arena_height = ARENA_HEIGHT / 2.0f;
     static std::uniform_real_distribution<float> radiusDist(Player::visibility_radius - 2 * player_radious,
@@ -23,8 +24,8 @@ bool Enemies::spawn(const EnemyModels& enemy_models, const Vector2& player_pos)
     auto enemy = enemies::random_enemy(cap_diff, cap);
     if (!enemy.has_value()) return false;
 
-    auto radius = radiusDist(rng::get());
-    auto angle = angleDist(rng::get());
+    auto radius = radiusDist(rng::get(rng::Stream::Spawner));
+    auto angle = angleDist(rng::get(rng::Stream::Spawner));
     auto enemy_pos = Vector2{
         .x = radius * std::cos(angle) + player_pos.x,
         .y = radius * std::sin(angle) + player_pos.y,
@@ -33,48 +34,53 @@ bool Enemies::spawn(const EnemyModels& enemy_models, const Vector2& player_pos)
 
     uint16_t base_level = static_cast<uint16_t>(std::ceil(static_cast<float>(killed) / 5.0f));
     std::uniform_int_distribution<uint16_t> dist(base_level <= 2 ? 1 : base_level - 2, base_level + 2);
-    uint16_t lvl = dist(rng::get());
+    uint16_t lvl = dist(rng::get(rng::Stream::Spawner));
 
-    auto bone_data = enemy_models.get_bone_transforms(*enemy);
-    enemies.insert(enemy_pos, lvl, false, std::move(enemy.value()), std::move(bone_data));
+    enemies.insert(enemy_pos, lvl, false, std::move(enemy.value()));
     return true;
 }
 
-void Enemies::update_health_bars() {
-    for (std::size_t i = 0; i < enemies.data->size(); i++) {
-        enemies.data.vec[i].val.update_health_bar();
-    }
-}
-
-uint32_t Enemies::tick(const shapes::Circle& target_hitbox, EnemyModels& enemy_models) {
-    static uint8_t tick_count = 0;
-
-    uint32_t acc = 0;
-    for (std::size_t i = 0; i < enemies.data->size(); i++) {
-        acc += enemies.data.vec[i].val.tick(enemies, i, target_hitbox, enemy_models);
-        enemies.reinsert(i);
-    }
+uint32_t Enemies::tick(const shapes::Circle& target_hitbox) {
+    profiler::Scope zone("Enemies::tick");
 
-    enemies.rebuild();
+    auto acc = enemies.tick(target_hitbox);
 
-    if (++tick_count == 20) {
-        spawn(enemy_models, target_hitbox.center);
-        tick_count = 0;
+    if (++spawn_ticks == 20) {
+        spawn(target_hitbox.center);
+        spawn_ticks = 0;
     }
 
     return acc;
 }
 
-void Enemies::draw(Camera cam, EnemyModels& enemy_models, const Vector3& offset, const shapes::Circle& visibility_circle) {
-    for (auto& enemy : *enemies.data) {
-        if (check_collision(visibility_circle, xz_component(Vector3Add(enemy.val.pos, offset)))) {
-            enemy.val.update_bones(enemy_models);
-            enemy.val.draw(cam, enemy_models, offset);
-        }
+void Enemies::draw(EnemyModels& enemy_models, HealthBars& health_bars, std::span<const Vector3> offsets,
+                   const shapes::Circle& visibility_circle, float interpolation, float delta_time) {
+    profiler::Scope zone("Enemies::draw");
+
+    EnemyPool::View view{
+        .center = visibility_circle.center,
+        .interpolation = std::clamp(interpolation, 0.0f, 1.0f),
+        .delta_time = delta_time,
+    };
+
+    enemies.new_frame();
+    for (const auto& offset : offsets) {
+        // the part of the arena that ends up inside the circle once moved by `offset`
+        auto circle = visibility_circle;
+        circle.translate(-xz_component(offset));
+
+        enemies.bodies.query(bounding_box(circle),
+                             [&circle](const enemies::Body& body) { return check_collision(circle, body.pos); },
+                             [&](enemies::Body& body, std::size_t) {
+                                 enemies.draw(body.entity, body.pos, enemy_models, health_bars, offset, view);
+                             });
     }
 
+    enemy_models.flush();
+    health_bars.flush();
+
 #ifdef DEBUG
-    enemies.draw_bbs(RED, false);
+    enemies.bodies.draw_bbs(RED, false);
 #endif
 }
 
@@ -3,10 +3,12 @@
 #include "enemies.hpp"
 #include "hitbox.hpp"
 #include "item_drops.hpp"
+#include "profiler.hpp"
 #include "quadtree.hpp"
 #include "rayhacks.hpp"
 #include "utility.hpp"
 #include <cstdint>
+#include <span>
 #include <vector>
 
 struct Enemies {
@@ -14,83 +16,79 @@ struct Enemies {
     static constexpr float player_radious = 50.0f;
 
     uint32_t max_cap;
+    // kills raise `max_cap` up to here
+    uint32_t cap_limit = 500;
     uint32_t cap;
-    QT<false> enemies;
+    EnemyPool enemies;
     uint64_t killed = 0;
     uint32_t stored_exp = 0;
     uint64_t stored_souls = 0;
+    // ticks since the last spawn
+    uint8_t spawn_ticks = 0;
 
-    Enemies(uint32_t max_cap) : max_cap(max_cap), cap(0), enemies(arena::arena_rec) {
+    Enemies(uint32_t max_cap) : max_cap(max_cap), cap(0), enemies(arena::arena_rec, true) {
     }
 
     // true - enemy spawned
     // false - cap is maxed out
-    bool spawn(const EnemyModels& enemy_models, const Vector2& player_pos);
+    bool spawn(const Vector2& player_pos);
 
     template <Shape S>
-    uint32_t deal_damage(S shape, uint64_t damage, Element element, std::vector<ItemDrop>& item_drop_pusher) {
+    uint32_t deal_damage(S shape, uint64_t damage, Element element, ItemDrops& item_drops) {
+        profiler::Scope zone("Enemies::deal_damage");
         uint32_t spell_exp = 0;
-        enemies.search_by(
-            [&shape](const quadtree::Box& bbox) -> bool {
-                shapes::Polygon rec = static_cast<Rectangle>(bbox);
-
-                for (const auto& origin : {Vector2Zero(), arena::top_origin, arena::right_origin, arena::bottom_origin,
-                                           arena::left_origin}) {
-                    shape.translate(origin);
-                    if (check_collision(rec, shape)) {
-                        return true;
-                        shape.translate(-origin);
+
+        // enemies are stored by their center, so boxes have to be checked against the shape's reach
+        auto reach = bounding_box(shape);
+        reach.x -= enemies::max_hitbox_radius;
+        reach.y -= enemies::max_hitbox_radius;
+        reach.width += 2.0f * enemies::max_hitbox_radius;
+        reach.height += 2.0f * enemies::max_hitbox_radius;
+
+        enemies.bodies.for_each_image(reach, [&](const Vector2& shift) {
+            quadtree::Box bounds = reach;
+            bounds.min += shift;
+            bounds.max += shift;
+            shape.translate(shift);
+
+            enemies.bodies.query(
+                bounds, [&](const enemies::Body& body) { return check_collision(shape, body.hitbox()); },
+                [&](enemies::Body& body, std::size_t ix) {
+                    auto dead = enemies.take_damage(body.entity, damage, element);
+                    if (!dead) return;
+                    auto [exp, souls] = *dead;
+                    auto [level, state] = *enemies.world.get<enemy_level, enemies::State>(body.entity);
+
+                    if (rng::value(rng::Stream::Drops, 0, 5) == 0) {
+                        item_drops.add_item_drop(level, body.pos);
                     }
-                    shape.translate(-origin);
-                }
-
-                return false;
-            },
-            [&](const auto& enemy) {
-                auto& hitbox = enemy.simple_hitbox;
-
-                for (const auto& origin : {Vector2Zero(), arena::top_origin, arena::right_origin, arena::bottom_origin,
-                                           arena::left_origin}) {
-                    shape.translate(origin);
-                    if (check_collision(shape, hitbox)) {
-                        return true;
-                        shape.translate(-origin);
+
+                    if (auto enemy_cap = enemies::get_info(state).cap_value; enemy_cap < cap) {
+                        cap -= enemy_cap;
+                    } else {
+                        cap = 0;
                     }
-                    shape.translate(-origin);
-                }
-
-                return false;
-            },
-            [&](auto& enemy, auto ix) {
-                auto dead = enemy.take_damage(damage, element);
-                if (!dead) return;
-                auto [exp, souls] = *dead;
-
-                if (GetRandomValue(0, 5) == 0) {
-                    item_drop_pusher.emplace_back(enemy.level, xz_component(enemy.pos));
-                }
-
-                if (auto enemy_cap = enemies::get_info(enemy.state).cap_value; enemy_cap < cap) {
-                    cap -= enemy_cap;
-                } else {
-                    cap = 0;
-                }
-                max_cap = std::min<uint32_t>(max_cap + 1, 500);
-
-                killed++;
-                stored_exp += exp;
-                spell_exp += exp;
-                stored_souls += souls;
-                enemies.remove(ix);
-            });
+                    max_cap = std::min<uint32_t>(max_cap + 1, cap_limit);
+
+                    killed++;
+                    stored_exp += exp;
+                    spell_exp += exp;
+                    stored_souls += souls;
+                    enemies.remove(ix);
+                });
+
+            shape.translate(-shift);
+        });
 
         return spell_exp;
     }
 
-    void update_health_bars();
-    uint32_t tick(const shapes::Circle& target_hitbox, EnemyModels& enemy_models);
+    uint32_t tick(const shapes::Circle& target_hitbox);
 
-    void draw(Camera cam, EnemyModels& enemy_models, const Vector3& offset, const shapes::Circle& visibility_circle);
+    // every offset is one of the arena tiles in view, all of them get drawn at once
+    // `interpolation` is how far along the frame is between two ticks, from 0 to 1
+    void draw(EnemyModels& enemy_models, HealthBars& health_bars, std::span<const Vector3> offsets,
+              const shapes::Circle& visibility_circle, float interpolation, float delta_time);
 
     uint32_t take_exp();
     uint64_t take_souls();
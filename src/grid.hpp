@@ -0,0 +1,371 @@
+#pragma once
+
+#include "quadtree.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <raylib.h>
+#include <raymath.h>
+#include <utility>
+#include <vector>
+
+namespace grid {
+    using quadtree::Box;
+    using quadtree::HasPosition;
+    using quadtree::SlotMap;
+
+    // what users of a spatial index rely on, `quadtree::QuadTree` and `grid::Grid` both provide it
+    template <typename I, typename T>
+    concept Broadphase = requires(I index, std::size_t ix, const Vector2& point, const Box& bounds) {
+        { index.data.vec[ix] } -> std::same_as<T&>;
+        { index.update(ix) } -> std::same_as<bool>;
+        { index.remove(ix) } -> std::same_as<void>;
+        { index.maintain() } -> std::same_as<void>;
+        { index.closest_to(point) } -> std::same_as<std::optional<std::size_t>>;
+        index.for_each_image(bounds, [](const Vector2&) {});
+        index.query(bounds, [](const T&) { return true; }, [](T&, std::size_t) {});
+    };
+
+    // uniform grid of square cells, good for lots of similarly sized things that all move every tick
+    // entries are kept sorted by cell in flat arrays, rebuilt with a counting sort by `maintain`
+    // entries that moved to another cell or got inserted since then live in `overflow` which every query scans
+    template <typename T, bool __SkipPositionCheck = false>
+        requires __SkipPositionCheck || HasPosition<T>
+    class Grid {
+      public:
+        static constexpr uint32_t dead = static_cast<uint32_t>(-1);
+        // marks `entry_pos` as pointing into `overflow`
+        static constexpr uint32_t overflow_bit = 1u << 31;
+
+        Box bbox;
+        float cell_size;
+        uint32_t columns;
+        uint32_t rows;
+        bool toroidal;
+
+        SlotMap<T> data;
+        // parallel to `data.vec`
+        std::vector<uint32_t> cells;
+        std::vector<uint32_t> entry_pos;
+
+        // `cell_entries[cell_start[c]..cell_start[c + 1]]` are the data indices in cell `c`, or `dead`
+        std::vector<uint32_t> cell_start;
+        std::vector<uint32_t> cell_entries;
+        std::vector<uint32_t> overflow;
+        std::size_t stale = 0;
+
+        Grid(Box bbox, bool toroidal = false, float cell_size = 50.0f)
+            : bbox(bbox), cell_size(cell_size),
+              columns(static_cast<uint32_t>(std::max(1.0f, std::ceil((bbox.max.x - bbox.min.x) / cell_size)))),
+              rows(static_cast<uint32_t>(std::max(1.0f, std::ceil((bbox.max.y - bbox.min.y) / cell_size)))),
+              toroidal(toroidal), cell_start(columns * rows + 1, 0) {};
+
+        operator Grid<T, false>&() {
+            return reinterpret_cast<Grid<T, false>&>(*this);
+        }
+
+        operator Grid<T, true>&() {
+            return reinterpret_cast<Grid<T, true>&>(*this);
+        }
+
+        template <typename... Args> quadtree::Handle insert(Args&&... args) {
+            auto handle = data.emplace(std::forward<Args>(args)...);
+            auto data_ix = static_cast<uint32_t>(data->size() - 1);
+
+            cells.emplace_back(cell_of(data.vec[data_ix].position()));
+            entry_pos.emplace_back(overflow_bit | static_cast<uint32_t>(overflow.size()));
+            overflow.emplace_back(data_ix);
+            stale++;
+
+            return handle;
+        }
+
+        void remove(std::size_t data_ix) {
+            if (data_ix >= data->size()) return;
+
+            auto last = data->size() - 1;
+            entry(data_ix) = dead;
+            if (data_ix != last) {
+                entry(last) = static_cast<uint32_t>(data_ix);
+                cells[data_ix] = cells[last];
+                entry_pos[data_ix] = entry_pos[last];
+            }
+
+            cells.pop_back();
+            entry_pos.pop_back();
+            data.remove_at(data_ix);
+            stale++;
+        }
+
+        void remove(const quadtree::Handle& handle) {
+            if (auto data_ix = data.lookup(handle); data_ix) remove(*data_ix);
+        }
+
+        // call after changing the position of `data_ix`
+        // returns true if the entry changed cells
+        bool update(std::size_t data_ix) {
+            auto cell = cell_of(data.vec[data_ix].position());
+            if (cell == cells[data_ix]) return false;
+
+            entry(data_ix) = dead;
+            cells[data_ix] = cell;
+            entry_pos[data_ix] = overflow_bit | static_cast<uint32_t>(overflow.size());
+            overflow.emplace_back(static_cast<uint32_t>(data_ix));
+            stale++;
+
+            return true;
+        }
+
+        // counting sort of every entry by cell, empties `overflow`
+        void maintain() {
+            if (stale == 0) return;
+
+            std::ranges::fill(cell_start, 0);
+            for (auto cell : cells) {
+                cell_start[cell + 1]++;
+            }
+            for (std::size_t c = 1; c < cell_start.size(); c++) {
+                cell_start[c] += cell_start[c - 1];
+            }
+
+            cell_entries.resize(cells.size());
+            // `cell_start[c]` is used as the insertion cursor of cell `c`, which leaves it at the cell's end, shifting
+            // everything over by one turns the ends back into starts
+            for (uint32_t i = 0; i < cells.size(); i++) {
+                auto pos = cell_start[cells[i]]++;
+                cell_entries[pos] = i;
+                entry_pos[i] = pos;
+            }
+            for (std::size_t c = cell_start.size() - 1; c > 0; c--) {
+                cell_start[c] = cell_start[c - 1];
+            }
+            cell_start[0] = 0;
+
+            overflow.clear();
+            stale = 0;
+        }
+
+        void rebuild() {
+            for (std::size_t i = 0; i < data->size(); i++) {
+                cells[i] = cell_of(data.vec[i].position());
+            }
+            stale++;
+            maintain();
+        }
+
+        // same contract as `QuadTree::search_by`, `check_box` gets the bbox of a cell
+        template <typename CheckBox, typename CheckData, typename F>
+        void search_by(CheckBox&& check_box, CheckData&& check_data, F&& f) {
+            for (uint32_t cell = 0; cell < columns * rows; cell++) {
+                if (cell_start[cell] == cell_start[cell + 1] || !check_box(cell_bbox(cell))) continue;
+
+                for (auto i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+                    visit(cell_entries[i], check_data, f);
+                }
+            }
+
+            for (std::size_t i = 0; i < overflow.size(); i++) {
+                if (overflow[i] != dead && check_box(cell_bbox(cells[overflow[i]]))) visit(overflow[i], check_data, f);
+            }
+        }
+
+        // same contract as `QuadTree::query`, only looks at the cells under `bounds`
+        template <typename CheckData, typename F> void query(const Box& bounds, CheckData&& check_data, F&& f) {
+            auto min = cell_coords(bounds.min);
+            auto max = cell_coords(bounds.max);
+
+            for (auto y = min.second; y <= max.second; y++) {
+                for (auto x = min.first; x <= max.first; x++) {
+                    auto cell = y * columns + x;
+
+                    for (auto i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+                        visit(cell_entries[i], check_data, f);
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < overflow.size(); i++) {
+                if (overflow[i] == dead) continue;
+
+                auto x = cells[overflow[i]] % columns;
+                auto y = cells[overflow[i]] / columns;
+                if (x >= min.first && x <= max.first && y >= min.second && y <= max.second) {
+                    visit(overflow[i], check_data, f);
+                }
+            }
+        }
+
+        template <typename F> void in_box(const Box& box, F&& f) {
+            query(box, [&box](const T& t) { return box.contains(t.position()); }, f);
+        }
+
+        template <typename F> void for_each_image(const Box& bounds, F&& f) const {
+            if (!toroidal) {
+                f(Vector2Zero());
+                return;
+            }
+
+            quadtree::for_each_image(bbox, bounds, f);
+        }
+
+        std::optional<std::size_t> closest_to(const Vector2& point) const {
+            auto nearest = k_nearest(point, 1);
+            if (nearest.empty()) return std::nullopt;
+
+            return nearest.front();
+        }
+
+        // data indices of the `k` entries closest to `point`, closest first
+        // walks rings of cells around `point`, everything outside of ring `r` is at least `r * cell_size` away, so once
+        // the k-th closest entry is nearer than that there's nothing left to find
+        std::vector<std::size_t> k_nearest(const Vector2& point, std::size_t k) const {
+            using Found = std::pair<float, std::size_t>;
+
+            std::vector<Found> found;
+            if (k == 0 || data->empty()) return {};
+            found.reserve(k + 1);
+
+            auto consider = [&](uint32_t data_ix) {
+                if (data_ix == dead) return;
+
+                auto dist = distance_sqr(data.vec[data_ix].position(), point);
+                if (found.size() == k) {
+                    if (dist >= found.front().first) return;
+
+                    std::ranges::pop_heap(found);
+                    found.pop_back();
+                }
+
+                found.emplace_back(dist, data_ix);
+                std::ranges::push_heap(found);
+            };
+
+            for (auto data_ix : overflow) {
+                consider(data_ix);
+            }
+
+            auto center = cell_of(point);
+            auto cx = static_cast<int64_t>(center % columns);
+            auto cy = static_cast<int64_t>(center / columns);
+
+            for (int64_t r = 0;; r++) {
+                // a ring wider than the grid would wrap onto cells that were already visited, at that point the grid
+                // is so sparse that looking at everything is just as good
+                if (2 * r + 1 > std::min(columns, rows)) {
+                    found.clear();
+                    for (uint32_t data_ix = 0; data_ix < data->size(); data_ix++) {
+                        consider(data_ix);
+                    }
+                    break;
+                }
+
+                for (int64_t y = cy - r; y <= cy + r; y++) {
+                    // only the border of the ring, the inside was done by the previous rings
+                    int64_t step = (y == cy - r || y == cy + r) ? 1 : std::max<int64_t>(2 * r, 1);
+                    for (int64_t x = cx - r; x <= cx + r; x += step) {
+                        auto cell = wrap_cell(x, y);
+                        if (!cell) continue;
+
+                        for (auto i = cell_start[*cell]; i < cell_start[*cell + 1]; i++) {
+                            consider(cell_entries[i]);
+                        }
+                    }
+                }
+
+                auto reach = static_cast<float>(r) * cell_size;
+                if (found.size() == k && found.front().first <= reach * reach) break;
+            }
+
+            std::ranges::sort_heap(found);
+
+            std::vector<std::size_t> ret;
+            ret.reserve(found.size());
+            for (const auto& [_, data_ix] : found) {
+                ret.emplace_back(data_ix);
+            }
+
+            return ret;
+        }
+
+        float distance_sqr(const Vector2& a, const Vector2& b) const {
+            auto dx = std::abs(a.x - b.x);
+            auto dy = std::abs(a.y - b.y);
+
+            if (toroidal) {
+                dx = std::min(dx, bbox.max.x - bbox.min.x - dx);
+                dy = std::min(dy, bbox.max.y - bbox.min.y - dy);
+            }
+
+            return dx * dx + dy * dy;
+        }
+
+        // things outside of the grid get wrapped into it if it's toroidal, clamped to the border cells otherwise
+        uint32_t cell_of(const Vector2& point) const {
+            auto x = static_cast<int64_t>(std::floor((point.x - bbox.min.x) / cell_size));
+            auto y = static_cast<int64_t>(std::floor((point.y - bbox.min.y) / cell_size));
+
+            if (toroidal && !bbox.contains(point)) {
+                x = (x % columns + columns) % columns;
+                y = (y % rows + rows) % rows;
+            } else {
+                x = std::clamp<int64_t>(x, 0, columns - 1);
+                y = std::clamp<int64_t>(y, 0, rows - 1);
+            }
+
+            return static_cast<uint32_t>(y * columns + x);
+        }
+
+        Box cell_bbox(uint32_t cell) const {
+            auto x = static_cast<float>(cell % columns);
+            auto y = static_cast<float>(cell / columns);
+            Vector2 min = {bbox.min.x + x * cell_size, bbox.min.y + y * cell_size};
+
+            return Box(min, {min.x + cell_size, min.y + cell_size});
+        }
+
+        void draw_bbs(Color col, bool two_d) {
+            for (uint32_t cell = 0; cell < columns * rows; cell++) {
+                if (cell_start[cell] != cell_start[cell + 1]) cell_bbox(cell).draw(col, two_d);
+            }
+        }
+
+      private:
+        template <typename CheckData, typename F> void visit(uint32_t data_ix, CheckData& check_data, F& f) {
+            if (data_ix == dead) return;
+
+            if (check_data(std::as_const(data.vec[data_ix]))) {
+                f(data.vec[data_ix], static_cast<std::size_t>(data_ix));
+            }
+        }
+
+        // cell column and row of `point` clamped to the grid, for query ranges
+        std::pair<uint32_t, uint32_t> cell_coords(const Vector2& point) const {
+            auto x = std::floor((point.x - bbox.min.x) / cell_size);
+            auto y = std::floor((point.y - bbox.min.y) / cell_size);
+
+            return {static_cast<uint32_t>(std::clamp(x, 0.0f, static_cast<float>(columns - 1))),
+                    static_cast<uint32_t>(std::clamp(y, 0.0f, static_cast<float>(rows - 1)))};
+        }
+
+        uint32_t& entry(std::size_t data_ix) {
+            auto pos = entry_pos[data_ix];
+            if (pos & overflow_bit) return overflow[pos & ~overflow_bit];
+
+            return cell_entries[pos];
+        }
+
+        std::optional<uint32_t> wrap_cell(int64_t x, int64_t y) const {
+            if (toroidal) {
+                x = (x % columns + columns) % columns;
+                y = (y % rows + rows) % rows;
+            } else if (x < 0 || y < 0 || x >= columns || y >= rows) {
+                return std::nullopt;
+            }
+
+            return static_cast<uint32_t>(y * columns + x);
+        }
+    };
+}
@@ -1,5 +1,6 @@
 #include "hitbox.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <raylib.h>
@@ -228,3 +229,25 @@ void translate(Vector2& point, const Vector2& vec) {
     point.x += vec.x;
     point.y += vec.y;
 }
+
+Rectangle bounding_box(const shapes::Polygon& poly) {
+    Vector2 min = poly.points[0];
+    Vector2 max = poly.points[0];
+    for (const auto& p : poly.points) {
+        min = {std::min(min.x, p.x), std::min(min.y, p.y)};
+        max = {std::max(max.x, p.x), std::max(max.y, p.y)};
+    }
+
+    return Rectangle{.x = min.x, .y = min.y, .width = max.x - min.x, .height = max.y - min.y};
+}
+
+Rectangle bounding_box(const shapes::Circle& circle) {
+    return Rectangle{.x = circle.center.x - circle.radius,
+                     .y = circle.center.y - circle.radius,
+                     .width = 2.0f * circle.radius,
+                     .height = 2.0f * circle.radius};
+}
+
+Rectangle bounding_box(const Vector2& point) {
+    return Rectangle{.x = point.x, .y = point.y, .width = 0.0f, .height = 0.0f};
+}
@@ -53,11 +53,16 @@ void translate(shapes::Polygon& poly, const Vector2& vec);
 void translate(shapes::Circle& circle, const Vector2& vece);
 void translate(Vector2& point, const Vector2& vece);
 
+Rectangle bounding_box(const shapes::Polygon& poly);
+Rectangle bounding_box(const shapes::Circle& circle);
+Rectangle bounding_box(const Vector2& point);
+
 template <typename T>
 concept Shape = requires (const T& shape, T& shapeRef, const Vector2& vec, const shapes::Polygon& poly) {
     { check_collision(shape, shape) } -> std::same_as<bool>;
     { check_collision(poly, shape) } -> std::same_as<bool>;
     { translate(shapeRef, vec) } -> std::same_as<void>;
+    { bounding_box(shape) } -> std::same_as<Rectangle>;
 };
 
 static_assert(Shape<shapes::Circle>);
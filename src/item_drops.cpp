@@ -8,25 +8,38 @@ effects::Id effect_from_rarity(const Rarity& rarity, const Vector2& center) {
     return effects::push_effect(effect::ItemDrop{ .y = 1.0f }(center, rarity::get_rarity_info(rarity).color));
 }
 
-ItemDrop::ItemDrop(Vector2 center, Spell&& spell) : item(std::move(spell)), hitbox(center, hitbox_radius) {
-    make_effect();
+ItemDrops::~ItemDrops() {
+    world.make_system<effects::Id>().run([](effects::Id& effect_id) { effects::pop_effect(effect_id); });
 }
 
-ItemDrop::ItemDrop(uint32_t level, const Vector2& center) : item(Spell::random(level)), hitbox(center, hitbox_radius) {
-    make_effect();
+void ItemDrops::add_item_drop(Vector2 center, Spell&& spell) {
+    auto effect_id = effect_from_rarity(spell.rarity, center);
+
+    ecs::Entity entity;
+    if (free_entities.empty()) {
+        entity = world.new_entity();
+    } else {
+        entity = free_entities.back();
+        free_entities.pop_back();
+    }
+
+    world.static_set_entity<Archetype>(entity, Item(std::move(spell)), shapes::Circle(center, hitbox_radius),
+                                       effect_id);
 }
 
-ItemDrop::~ItemDrop() {
-    effects::pop_effect(effect_id);
+void ItemDrops::add_item_drop(uint32_t level, const Vector2& center) {
+    add_item_drop(center, Spell::random(level));
 }
 
-void ItemDrop::draw_name(std::function<Vector2(Vector3)> to_screen_coords) const {
-    Vector2 pos = to_screen_coords((Vector3){hitbox.center.x, 0.0f, hitbox.center.y});
-    auto name = get_name().data();
-    DrawText(name, static_cast<int>(pos.x), static_cast<int>(pos.y), 20, WHITE);
+void ItemDrops::remove(ecs::Entity entity) {
+    auto [effect_id] = *world.get<effects::Id>(entity);
+    effects::pop_effect(effect_id);
+
+    world.remove(entity);
+    free_entities.emplace_back(entity);
 }
 
-std::string_view ItemDrop::get_name() const {
+std::string_view ItemDrops::get_name(const Item& item) {
     return std::visit(
         [](auto&& arg) -> std::string_view {
             using T = std::decay_t<decltype(arg)>;
@@ -38,26 +51,11 @@ std::string_view ItemDrop::get_name() const {
         item);
 }
 
-ItemDrop ItemDrop::random(uint32_t level, const Vector2& center) {
-    return ItemDrop(center, Spell::random(level));
-}
-
-void ItemDrop::make_effect() {
-    std::visit(
-        [&](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-
-            if constexpr (std::same_as<T, Spell>) {
-                effect_id = effect_from_rarity(arg.rarity, hitbox.center);
-            }
-        },
-        item);
-}
-
 #ifdef DEBUG
-void ItemDrops::draw_item_drop_names(std::function<Vector2(Vector3)> to_screen_coords) const {
-    for (const auto& drop : item_drops) {
-        drop.draw_name(to_screen_coords);
-    }
+void ItemDrops::draw_item_drop_names(std::function<Vector2(Vector3)> to_screen_coords) {
+    world.make_system<const Item, const shapes::Circle>().run([&](const Item& item, const shapes::Circle& hitbox) {
+        Vector2 pos = to_screen_coords((Vector3){hitbox.center.x, 0.0f, hitbox.center.y});
+        DrawText(get_name(item).data(), static_cast<int>(pos.x), static_cast<int>(pos.y), 20, WHITE);
+    });
 }
 #endif
@@ -1,75 +1,58 @@
 #pragma once
 
+#include "ecs.hpp"
 #include "particle/effects.hpp"
 #include "hitbox.hpp"
 #include "spell.hpp"
 #include <functional>
 #include <string_view>
 #include <variant>
+#include <vector>
 
-class ItemDrop {
-  public:
+// every item laying on the ground is an entity, its effect gets popped together with it
+struct ItemDrops {
     static constexpr float hitbox_radius = 15.0f;
 
     using Item = std::variant<Spell>;
-    Item item;
-    shapes::Circle hitbox;
+    using Archetype = ecs::Archetype<Item, shapes::Circle, effects::Id>;
 
-    effects::Id effect_id;
+    ecs::build<Archetype> world;
+    // entities of picked up items, handed out again before asking `world` for new ones
+    std::vector<ecs::Entity> free_entities;
 
-    ItemDrop(Vector2 center, Spell&& spell);
-    ItemDrop(uint32_t level, const Vector2& center);
+    ItemDrops() = default;
 
-    ItemDrop(const ItemDrop&) = delete;
-    ItemDrop& operator=(const ItemDrop&) = delete;
+    ItemDrops(const ItemDrops&) = delete;
+    ItemDrops& operator=(const ItemDrops&) = delete;
 
-    ItemDrop(ItemDrop&& i) noexcept : item(std::move(i.item)), hitbox(std::move(i.hitbox)), effect_id(i.effect_id) {
-        i.effect_id = {-1, -1};
-    };
-    ItemDrop& operator=(ItemDrop&& i) noexcept {
-        if (this != &i) {
-            item = std::move(i.item);
-            hitbox = std::move(i.hitbox);
-            effect_id = i.effect_id;
-            i.effect_id = {-1, -1};
-        }
+    // a moved from `world` still points at the same archetypes, the destructor would pop the effects twice
+    ItemDrops(ItemDrops&&) = delete;
+    ItemDrops& operator=(ItemDrops&&) = delete;
 
-        return *this;
-    };
+    ~ItemDrops();
 
-    ~ItemDrop();
-
-    void draw_name(std::function<Vector2(Vector3)> to_screen_coords) const;
-    std::string_view get_name() const;
-
-    static ItemDrop random(uint32_t level, const Vector2& center);
-
-  private:
-    void make_effect();
-};
-
-struct ItemDrops {
-    std::vector<ItemDrop> item_drops;
-
-    template <typename... Args> void add_item_drop(Args&&... args) {
-        item_drops.emplace_back(std::forward<Args>(args)...);
-    }
+    void add_item_drop(Vector2 center, Spell&& spell);
+    void add_item_drop(uint32_t level, const Vector2& center);
+    void remove(ecs::Entity entity);
 
     void pickup(const Shape auto& shape, auto handler) {
-        std::size_t i = 0;
-        while (i < item_drops.size()) {
-            if (!check_collision(shape, item_drops[i].hitbox)) {
-                i++;
-                continue;
-            }
+        std::vector<ecs::Entity> picked;
+        world.make_system<const shapes::Circle>().run<ecs::WithIDs>(
+            [&](ecs::Entity entity, const shapes::Circle& hitbox) {
+                if (check_collision(shape, hitbox)) picked.emplace_back(entity);
+            });
+
+        for (auto entity : picked) {
+            auto [item] = *world.get<Item>(entity);
 
-            std::visit(handler, std::move(item_drops[i].item));
-            std::swap(item_drops[i], item_drops.back());
-            item_drops.pop_back();
+            std::visit(handler, std::move(item));
+            remove(entity);
         }
     };
 
+    static std::string_view get_name(const Item& item);
+
 #ifdef DEBUG
-    void draw_item_drop_names(std::function<Vector2(Vector3)> to_screen_coords) const;
+    void draw_item_drop_names(std::function<Vector2(Vector3)> to_screen_coords);
 #endif
 };
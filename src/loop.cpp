@@ -1,6 +1,7 @@
 #include "loop.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 
@@ -9,6 +10,7 @@
 #include <print>
 #include <raylib.h>
 #include <raymath.h>
+#include <span>
 #include <utility>
 #include <variant>
 
@@ -20,6 +22,9 @@
 #include "item_drops.hpp"
 #include "player.hpp"
 #include "power_up.hpp"
+#include "profiler.hpp"
+#include "quadtree.hpp"
+#include "sim.hpp"
 #include "spell.hpp"
 #include "spell_caster.hpp"
 #include "ui.hpp"
@@ -253,8 +258,6 @@ void Arena::draw(Loop& loop) {
         player_view_quad.materials[0].shader = LoadShader("./assets/floor.vs.glsl", "./assets/floor.fs.glsl");
     }
 
-    enemies.update_health_bars();
-
 
     BeginTextureMode(loop.assets[assets::Target]);
     ClearBackground(WHITE);
@@ -273,28 +276,26 @@ void Arena::draw(Loop& loop) {
 
     auto circle =
         shapes::Circle(xz_component(player.position) + Player::visibility_center_offset, Player::visibility_radius);
-    auto vs = {
-        Vector3Zero(),
-        // UP
-        (Vector3){-ARENA_WIDTH, 0.0f, 0.0f},
-        // DOWN
-        (Vector3){ARENA_WIDTH, 0.0f, 0.0f},
-        // LEFT
-        (Vector3){0.0f, 0.0f, ARENA_HEIGHT},
-        // RIGHT
-        (Vector3){0.0f, 0.0f, -ARENA_HEIGHT},
-        // LEFT-DOWN
-        (Vector3){ARENA_WIDTH, 0.0f, ARENA_HEIGHT},
-        // RIGHT-DOWN
-        (Vector3){ARENA_WIDTH, 0.0f, -ARENA_HEIGHT},
-        // LEFT-UP
-        (Vector3){-ARENA_WIDTH, 0.0f, ARENA_HEIGHT},
-        // RIGHT-UP
-        (Vector3){-ARENA_WIDTH, 0.0f, -ARENA_HEIGHT},
-    };
-    for (const auto& v : vs) {
-        enemies.draw(player.camera, loop.enemy_models, v, circle);
 
+    // only the neighbouring arena tiles that can actually be seen get drawn
+    auto view = bounding_box(circle);
+    auto view_min = Vector2{std::min(view.x, player.interpolated_position.x + player_view_origin.x),
+                            std::min(view.y, player.interpolated_position.z + player_view_origin.z)};
+    auto view_max = Vector2{std::max(view.x + view.width,
+                                     player.interpolated_position.x + player_view_origin.x + player_view_dims.x),
+                            std::max(view.y + view.height,
+                                     player.interpolated_position.z + player_view_origin.z + player_view_dims.y)};
+    std::array<Vector3, 4> vs;
+    std::size_t vs_count = 0;
+    quadtree::for_each_image(arena::arena_rec, quadtree::Box(view_min, view_max), [&](const Vector2& shift) {
+        vs[vs_count++] = Vector3{-shift.x, 0.0f, -shift.y};
+    });
+
+    // nothing moves while paused, so enemies stay where the last tick left them
+    enemies.draw(loop.enemy_models, loop.health_bars, std::span(vs.data(), vs_count), circle,
+                 playing ? static_cast<float>(loop.accum_time) * TICKS : 1.0f,
+                 playing ? static_cast<float>(loop.delta_time) : 0.0f);
+    for (const auto& v : std::span(vs.data(), vs_count)) {
         if (soul_portal) {
             soul_portal->hitbox.draw_3D(BLACK, 1.0f, xz_component(v));
         }
@@ -304,7 +305,7 @@ void Arena::draw(Loop& loop) {
 #ifdef DEBUG
     circle.draw_3D(BLUE, 1.0f, Vector2Zero());
     DrawSphere({circle.center.x, 0.0f, circle.center.y}, 3.0f, BLUE);
-    caster::draw_hitbox(1.0f);
+    caster.draw_hitbox(1.0f);
 #endif
     EndMode3D();
 
@@ -330,9 +331,7 @@ void Arena::draw(Loop& loop) {
         DrawModelEx(soul_portal_arrow, pos, Vector3{0.0f, 1.0f, 0.0f}, angle, Vector3{1.0f, 1.0f, 1.0f}, WHITE);
     }
 
-    for (const auto& v : vs) {
-        effects::draw(v);
-    }
+    effects::draw(std::span(vs.data(), vs_count));
     EndMode3D();
 
 #ifdef DEBUG
@@ -400,7 +399,7 @@ void Arena::draw(Loop& loop) {
     DrawText(std::format("INTERPOLATED TOTAL POS: [{}, {}]", player.interpolated_total_position.x, player.interpolated_total_position.y).c_str(), 10, 50, 20,
              WHITE);
     DrawText(std::format("SCREEN: [{}, {}]", loop.screen.x, loop.screen.y).c_str(), 10, 70, 20, WHITE);
-    DrawText(std::format("ENEMIES: {}", enemies.enemies.data->size()).c_str(), 10, 90, 20, WHITE);
+    DrawText(std::format("ENEMIES: {}", enemies.enemies.size()).c_str(), 10, 90, 20, WHITE);
     DrawText(std::format("LVL: {}", player.lvl).c_str(), 10, 110, 20, WHITE);
     DrawText(std::format("UNLOCKED SPELL SPLOTS: {}", player.unlocked_spell_count).c_str(), 10, 130, 20, WHITE);
 #endif
@@ -552,25 +551,23 @@ void Arena::update(Loop& loop) {
                     return;
             }
 
-            auto spell_id = player.can_cast(num, loop.player_save->get_spellbook());
-            loop.player_save->cast_spell(spell_id, (Vector2){player.position.x, player.position.z}, mouse_xz, enemies,
-                                         player.mana);
+            sim::cast(num, mouse_xz, player, *loop.player_save, enemies, caster);
 
             return;
         }
     });
 
-    player.tick((Vector2){movement.x, movement.y}, angle.x / angle.y - 90.0f);
-    loop.player_save->tick_spellbook();
-    auto damage_done = enemies.tick(player.hitbox, loop.enemy_models);
-    souls += enemies.take_souls();
-    if (player.health <= damage_done) {
-        player.health = 0;
-    } else {
-        player.health -= damage_done;
-        if (player.add_exp(enemies.take_exp())) {
-            state.emplace<PowerUpSelection>(loop);
-        }
+    auto outcome = sim::tick(
+        sim::Input{
+            .movement = movement,
+            .angle = angle.x / angle.y - 90.0f,
+        },
+        player, *loop.player_save, enemies, item_drops, caster, souls);
+    if (outcome.leveled_up) {
+        state.emplace<PowerUpSelection>(loop);
+    }
+    if (outcome.picked_up_spells != 0) {
+        loop.player_save->save();
     }
 
     if (soul_portal && check_collision(soul_portal->hitbox, xz_component(player.position))) {
@@ -579,17 +576,6 @@ void Arena::update(Loop& loop) {
         souls = 0;
     }
 
-    caster::tick(loop.player_save->get_spellbook(), enemies, item_drops.item_drops);
-
-    item_drops.pickup(player.hitbox, [&](auto&& arg) {
-        using Item = std::decay_t<decltype(arg)>;
-
-        if constexpr (std::is_same_v<Item, Spell>) {
-            loop.player_save->add_spell_to_spellbook(std::move(arg));
-            loop.player_save->save();
-        }
-    });
-
     if (player.health == 0) {
         loop.player_save->save();
         loop.player_save->remove_default_spell();
@@ -995,6 +981,8 @@ Loop::Loop(int width, int height)
 };
 
 void Loop::operator()() {
+    profiler::begin_frame();
+
     double current_time = GetTime();
     delta_time = current_time - prev_time;
     prev_time = current_time;
@@ -1004,13 +992,28 @@ void Loop::operator()() {
     keys.poll();
     mouse.poll();
 
-    std::visit([&](auto&& arg) { arg.draw(*this); }, scene);
+    // works in every scene and in release builds, it's for finding out where frame spikes come from
+    if (IsKeyPressed(KEY_F3)) profiler::enable(!profiler::enabled());
+    if (IsKeyPressed(KEY_F4) && profiler::frame_count() != 0) profiler::export_chrome_trace("manalter_trace.json");
+
+    {
+        profiler::Scope zone("Loop::draw");
+        std::visit([&](auto&& arg) { arg.draw(*this); }, scene);
+    }
+    if (profiler::enabled()) {
+        BeginDrawing();
+        profiler::draw_overlay(screen);
+        EndDrawing();
+    }
     SwapScreenBuffer();
 
     while (accum_time >= (1.0 / TICKS)) {
+        profiler::Scope zone("Loop::update");
         update();
         accum_time -= 1.0 / TICKS;
     }
+
+    profiler::end_frame();
 }
 
 void Loop::update() {
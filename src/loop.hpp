@@ -9,6 +9,7 @@
 #include "item_drops.hpp"
 #include "player.hpp"
 #include "power_up.hpp"
+#include "spell_caster.hpp"
 #include "ui.hpp"
 #include <variant>
 
@@ -64,6 +65,7 @@ struct Arena {
     Player player;
     Enemies enemies;
     ItemDrops item_drops;
+    caster::Caster caster;
 
     uint64_t souls = 0;
     double game_time = 0.0;
@@ -150,6 +152,7 @@ struct Loop {
     assets::Store assets;
 
     EnemyModels enemy_models;
+    HealthBars health_bars;
     Shader skinning_shader;
 
     // scene isn't Main or SplashScreen -> player_stats has value
@@ -11,10 +11,10 @@
 const Vector3 Player::camera_offset = (Vector3){0.0f, 140.0f, 60.0f};
 const float Player::model_scale = 0.2f;
 
-Player::Player(Vector3 position, assets::Store& assets)
+Player::Player(Vector3 position)
     : prev_position(position), prev_total_position(Vector2{position.x, position.z}), position(position), total_position(Vector2{position.x, position.z}),
       interpolated_position(position), interpolated_total_position(Vector2{position.x, position.y}),
-      animations(nullptr), hitbox((Vector2){position.x, position.z}, 8.0f) {
+      animations(nullptr), animationsCount(0), hitbox((Vector2){position.x, position.z}, 8.0f) {
     equipped_spells.reset(new uint64_t[Player::max_spell_count]);
     for (std::size_t i = 0; i < Player::max_spell_count; i++) {
         equipped_spells[i] = std::numeric_limits<uint64_t>::max();
@@ -25,7 +25,9 @@ Player::Player(Vector3 position, assets::Store& assets)
     camera.up = (Vector3){0.0f, 1.0f, 0.0f};
     camera.fovy = 90.0f;
     camera.projection = CAMERA_PERSPECTIVE;
+}
 
+Player::Player(Vector3 position, assets::Store& assets) : Player(position) {
     auto model = assets[assets::Player];
 
     animations = LoadModelAnimations("./assets/player/player.glb", &animationsCount);
@@ -107,7 +109,7 @@ void Player::tick(Vector2 movement, float new_angle) {
         animationIndex = 2;
     }
 
-    if (lastIndex != animationIndex) {
+    if (lastIndex != animationIndex || animations == nullptr) {
         animationCurrent = 0;
     } else {
         animationCurrent = (animationCurrent + 3) % animations[animationIndex].frameCount;
@@ -159,7 +161,7 @@ bool Player::unlocks_spell_slot(uint16_t lvl) {
 }
 
 Player::~Player() {
-    UnloadModelAnimations(animations, animationsCount);
+    if (animations != nullptr) UnloadModelAnimations(animations, animationsCount);
 }
 
 void PlayerSave::load_save() {
@@ -220,12 +222,12 @@ void PlayerSave::remove_spell(uint64_t ix) {
 }
 
 void PlayerSave::cast_spell(uint64_t spell_id, const Vector2& player_position, const Vector2& mouse_pos,
-                            Enemies& enemies, uint64_t& mana) {
+                            Enemies& enemies, caster::Caster& caster, uint64_t& mana) {
     if (spell_id == std::numeric_limits<uint64_t>::max()) return;
 
     auto& spell = spellbook[spell_id];
 
-    if (caster::cast(spell_id, spell, player_position, mouse_pos, enemies)) {
+    if (caster.cast(spell_id, spell, player_position, mouse_pos, enemies)) {
         mana -= spell.stats.manacost.get();
         spell.current_cooldown = spell.cooldown;
         spells_to_tick.emplace_back(spell_id);
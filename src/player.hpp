@@ -6,6 +6,7 @@
 #include "power_up.hpp"
 #include "raylib.h"
 #include "spell.hpp"
+#include "spell_caster.hpp"
 #include "stats.hpp"
 #include <cstdint>
 #include <filesystem>
@@ -50,6 +51,8 @@ struct Player {
     std::unique_ptr<uint64_t[]> equipped_spells;
     uint8_t tick_counter = 0;
 
+    // without a model or animations, for when there's nothing to draw the player with
+    Player(Vector3 position);
     Player(Vector3 position, assets::Store& assets);
 
     Player(Player&) = delete;
@@ -102,7 +105,8 @@ class PlayerSave {
     void remove_default_spell();
     uint64_t add_spell_to_spellbook(Spell&& spell);
     void remove_spell(uint64_t ix);
-    void cast_spell(uint64_t spell_id, const Vector2& player_position, const Vector2& mouse_pos, Enemies& enemies, uint64_t& mana);
+    void cast_spell(uint64_t spell_id, const Vector2& player_position, const Vector2& mouse_pos, Enemies& enemies,
+                    caster::Caster& caster, uint64_t& mana);
     void tick_spellbook();
 
     inline void add_souls(uint64_t s) {
@@ -56,5 +56,5 @@ void PowerUp::apply(PlayerStats& stats) {
 PowerUp PowerUp::random() {
     static std::uniform_int_distribution<uint16_t> distr(0, static_cast<uint16_t>(powerups::Type::Size) - 1);
 
-    return powerups::make_random(static_cast<powerups::Type>(distr(rng::get())));
+    return powerups::make_random(static_cast<powerups::Type>(distr(rng::get(rng::Stream::PowerUps))));
 }
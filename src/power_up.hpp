@@ -38,7 +38,7 @@ namespace powerups {
             static_assert(count == std::extent_v<decltype(T::weights)>, "weights array size mismatch, go fix");
             static std::discrete_distribution<uint8_t> dist(std::begin(T::weights), std::end(T::weights));
 
-            return T::min + dist(rng::get()) * T::step;
+            return T::min + dist(rng::get(rng::Stream::PowerUps)) * T::step;
         }
     }
 
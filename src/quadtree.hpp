@@ -2,13 +2,19 @@
 
 #include "hitbox.hpp"
 #include "print"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <concepts>
 #include <cstdint>
 #include <format>
 #include <functional>
+#include <optional>
+#include <queue>
 #include <raylib.h>
 #include <raymath.h>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -44,6 +50,11 @@ namespace quadtree {
             return (min.x < other.max.x && max.x > other.min.x) && (min.y < other.max.y && max.y > other.min.y);
         }
 
+        bool intersect(const shapes::Circle& circle) const {
+            auto closest = Vector2Clamp(circle.center, min, max);
+            return Vector2DistanceSqr(closest, circle.center) <= circle.radius * circle.radius;
+        }
+
         bool wrap_around(Vector2& v) const {
             if (contains(v)) return false;
 
@@ -67,29 +78,135 @@ namespace quadtree {
         }
     };
 
-    template <typename T> struct IDed {
-        inline static uint64_t last_id = 0;
-        uint64_t id;
-        T val;
+    // calls `f(shift)` for every copy of `query` that overlaps the wrapping `world`, `shift` being what moves `query`
+    // onto that copy
+    // {0, 0} always gets called, a query hanging over an edge also gets the opposite side, 4 calls at most for a query
+    // over a corner
+    template <typename F> void for_each_image(const Box& world, const Box& query, F&& f) {
+        auto width = world.max.x - world.min.x;
+        auto height = world.max.y - world.min.y;
+
+        f(Vector2Zero());
+        for (float dy : {0.0f, -height, height}) {
+            for (float dx : {0.0f, -width, width}) {
+                if (dx == 0.0f && dy == 0.0f) continue;
+
+                Box image({query.min.x + dx, query.min.y + dy}, {query.max.x + dx, query.max.y + dy});
+                if (image.intersect(world)) f(Vector2{dx, dy});
+            }
+        }
+    }
+
+    struct Handle {
+        uint32_t index = static_cast<uint32_t>(-1);
+        uint32_t generation = 0;
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    static constexpr Handle null{};
+
+    // generational slot map
+    // values are stored densely in `vec`, handles point at a slot which knows where its value currently is
+    // removing a value bumps the slot's generation, so stale handles are caught without any searching
+    template <typename T> struct SlotMap {
+        struct Slot {
+            uint32_t dense_ix;
+            uint32_t generation;
+        };
+
+        std::vector<T> vec;
+        std::vector<uint32_t> dense_to_slot;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> free_slots;
 
-        template <typename U>
-            requires(!std::same_as<std::decay_t<U>, IDed>)
-        IDed(U&& val) : id(++last_id), val(std::forward<T>(val)) {
+        template <typename... Args> Handle emplace(Args&&... args) {
+            auto dense_ix = static_cast<uint32_t>(vec.size());
+            vec.emplace_back(std::forward<Args>(args)...);
+
+            uint32_t slot_ix;
+            if (free_slots.empty()) {
+                slot_ix = static_cast<uint32_t>(slots.size());
+                slots.emplace_back(dense_ix, 0);
+            } else {
+                slot_ix = free_slots.back();
+                free_slots.pop_back();
+                slots[slot_ix].dense_ix = dense_ix;
+            }
+            dense_to_slot.emplace_back(slot_ix);
+
+            return {slot_ix, slots[slot_ix].generation};
+        }
+
+        bool contains(const Handle& handle) const {
+            return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
         }
 
-        template <typename... Args>
-            requires std::constructible_from<T, Args...>
-        IDed(Args&&... args) : id(++last_id), val(std::forward<Args>(args)...) {
+        // dense index of `handle`, if it's still alive
+        std::optional<std::size_t> lookup(const Handle& handle) const {
+            if (!contains(handle)) return std::nullopt;
+
+            return slots[handle.index].dense_ix;
         }
 
-        IDed(IDed&& i) noexcept : id(i.id), val(std::move(i.val)) {
-            i.id = static_cast<uint64_t>(-1);
+        Handle handle_of(std::size_t dense_ix) const {
+            auto slot_ix = dense_to_slot[dense_ix];
+            return {slot_ix, slots[slot_ix].generation};
         }
-        IDed& operator=(IDed&&) noexcept = default;
-    };
 
-    using node_ix = uint16_t;
-    static constexpr node_ix null = node_ix(-1);
+        // swaps the last value into `dense_ix`
+        void remove_at(std::size_t dense_ix) {
+            auto last = vec.size() - 1;
+            auto slot_ix = dense_to_slot[dense_ix];
+
+            if (dense_ix != last) {
+                std::swap(vec[dense_ix], vec[last]);
+                dense_to_slot[dense_ix] = dense_to_slot[last];
+                slots[dense_to_slot[dense_ix]].dense_ix = static_cast<uint32_t>(dense_ix);
+            }
+
+            vec.pop_back();
+            dense_to_slot.pop_back();
+            slots[slot_ix].generation++;
+            free_slots.emplace_back(slot_ix);
+        }
+
+        void clear() {
+            for (auto slot_ix : dense_to_slot) {
+                slots[slot_ix].generation++;
+                free_slots.emplace_back(slot_ix);
+            }
+
+            vec.clear();
+            dense_to_slot.clear();
+        }
+
+        std::vector<T>& operator*() {
+            return vec;
+        }
+
+        const std::vector<T>& operator*() const {
+            return vec;
+        }
+
+        std::vector<T>* operator->() {
+            return &vec;
+        }
+
+        const std::vector<T>* operator->() const {
+            return &vec;
+        }
+
+        T& operator[](const Handle& handle) {
+            assert(contains(handle));
+            return vec[slots[handle.index].dense_ix];
+        }
+
+        const T& operator[](const Handle& handle) const {
+            assert(contains(handle));
+            return vec[slots[handle.index].dense_ix];
+        }
+    };
 
     struct Node {
         bool subdivided = false;
@@ -99,19 +216,22 @@ namespace quadtree {
         // [0, 1] - top right
         // [1, 0] - bottom left
         // [1, 1] - bottom right
-        std::pair<node_ix, uint64_t> children[2][2]{
-            {{null, -1}, {null, -1}},
-            {{null, -1}, {null, -1}},
+        Handle children[2][2]{
+            {null, null},
+            {null, null},
         };
-        std::vector<std::pair<std::size_t, uint64_t>> data_ixs_ided;
+        Handle parent = null;
+        uint8_t depth = 0;
+        std::vector<Handle> data;
 
         Node(Box bbox) : bbox(bbox) {};
+        Node(Box bbox, Handle parent, uint8_t depth) : bbox(bbox), parent(parent), depth(depth) {};
 
-        std::pair<node_ix, uint64_t>& operator[](int y, int x) {
+        Handle& operator[](int y, int x) {
             return children[y][x];
         }
 
-        const std::pair<node_ix, uint64_t>& operator[](int y, int x) const {
+        const Handle& operator[](int y, int x) const {
             return children[y][x];
         }
     };
@@ -144,333 +264,378 @@ namespace quadtree {
 
     static_assert(HasPosition<pos<int>>);
 
-    template <typename T> struct IDVec {
-        std::vector<IDed<T>> vec;
+    template <uint8_t MaxPerNode, typename T, bool __SkipPositionCheck = false>
+        requires __SkipPositionCheck || HasPosition<T>
+    class QuadTree {
+      public:
+        // nodes this deep don't subdivide anymore, keeps entries stacked on the same point from splitting forever and
+        // bounds the traversal stack
+        static constexpr uint8_t max_depth = 24;
+
+        SlotMap<Node> nodes;
+        Handle root;
+        SlotMap<T> data;
+        // leaf holding each data entry, parallel to `data.vec`
+        std::vector<Handle> leaves;
+        // entries removed or moved out of their leaf since the last prune
+        std::size_t stale = 0;
+        // distances wrap around the root bbox, for worlds where leaving one edge puts you on the opposite one
+        bool toroidal;
+
+        QuadTree(Box bbox, bool toroidal = false) : nodes(), root(nodes.emplace(bbox)), toroidal(toroidal) {};
 
-        template <typename Ix> bool lookup(Ix& ix, const uint64_t& id) const {
-            if (ix == static_cast<Ix>(-1)) return false;
+        operator QuadTree<MaxPerNode, T, false>&() {
+            return reinterpret_cast<QuadTree<MaxPerNode, T, false>&>(*this);
+        }
 
-            if (vec.size() > ix && (id == static_cast<uint64_t>(-1) || vec[ix].id == id)) return true;
+        operator QuadTree<MaxPerNode, T, true>&() {
+            return reinterpret_cast<QuadTree<MaxPerNode, T, true>&>(*this);
+        }
 
-            if (id == static_cast<uint64_t>(-1)) return false;
+        template <typename... Args> Handle insert(Args&&... args) {
+            auto handle = data.emplace(std::forward<Args>(args)...);
+            leaves.emplace_back(null);
 
-            for (std::size_t i = 0; i < vec.size(); i++) {
-                if (vec[i].id == id) {
-                    ix = i;
-                    return true;
-                }
+            if (!_insert(root, handle)) {
+                assert(false && "How???");
             }
 
-            return false;
+            return handle;
         }
 
-        std::vector<IDed<T>>& operator*() {
-            return vec;
-        }
+        void remove(std::size_t data_ix) {
+            if (data_ix >= data->size()) return;
 
-        const std::vector<IDed<T>>& operator*() const {
-            return vec;
+            std::swap(leaves[data_ix], leaves.back());
+            leaves.pop_back();
+            data.remove_at(data_ix);
+            stale++;
         }
 
-        std::vector<IDed<T>>* operator->() {
-            return &vec;
+        void remove(const Handle& handle) {
+            if (auto data_ix = data.lookup(handle); data_ix) remove(*data_ix);
         }
 
-        std::vector<IDed<T>> const* const operator->() const {
-            return &vec;
-        }
+        // `check_box(const Box&) -> bool` decides whether to descend into a node
+        // `check_data(const T&) -> bool` filters the entries of leaves that passed
+        // `f(T&, std::size_t data_ix)` gets called for every entry that passed, assumes `f` doesn't change position
+        template <typename CheckBox, typename CheckData, typename F>
+        void search_by(CheckBox&& check_box, CheckData&& check_data, F&& f) {
+            std::array<Handle, 3 * max_depth + 4> stack;
+            std::size_t top = 0;
+            stack[top++] = root;
 
-        T& operator[](std::size_t& ix, uint64_t id) {
-            if (!lookup(ix, id)) {
-                assert(false);
-            }
+            while (top != 0) {
+                const auto& node = nodes[stack[--top]];
+
+                if (!check_box(node.bbox)) continue;
+
+                if (node.subdivided) {
+                    stack[top++] = node[1, 1];
+                    stack[top++] = node[1, 0];
+                    stack[top++] = node[0, 1];
+                    stack[top++] = node[0, 0];
+                    continue;
+                }
+
+                for (const auto& dat : node.data) {
+                    auto data_ix = data.lookup(dat);
+                    if (!data_ix) continue;
 
-            return vec[ix].val;
+                    if (check_data(std::as_const(data.vec[*data_ix]))) {
+                        f(data.vec[*data_ix], *data_ix);
+                    }
+                }
+            }
         }
 
-        T& operator[](std::size_t ix, uint64_t id) {
-            auto _ix = ix;
-            if (!lookup(_ix, id)) {
-                assert(false);
+        // `quadtree::for_each_image` over the root bbox, only ever {0, 0} for trees that aren't toroidal
+        template <typename F> void for_each_image(const Box& query, F&& f) const {
+            if (!toroidal) {
+                f(Vector2Zero());
+                return;
             }
 
-            return vec[ix].val;
+            quadtree::for_each_image(nodes[root].bbox, query, f);
         }
 
-        const T& operator[](std::size_t& ix, uint64_t id) const {
-            if (!lookup(ix, id)) {
-                assert(false);
-            }
+        // `search_by` limited to the nodes overlapping `bounds`, the part of the interface every broadphase can answer
+        // without asking about each of its boxes
+        template <typename CheckData, typename F> void query(const Box& bounds, CheckData&& check_data, F&& f) {
+            search_by([&bounds](const Box& bbox) { return bounds.intersect(bbox); }, check_data, f);
+        }
 
-            return vec[ix].val;
+        template <typename F> void in_box(const Box& bbox, F&& f) {
+            query(bbox, [&bbox](const T& t) { return bbox.contains(t.position()); }, f);
         }
 
-        const T& operator[](std::size_t ix, uint64_t id) const {
-            auto _ix = ix;
-            if (!lookup(_ix, id)) {
-                assert(false);
-            }
+        std::optional<std::size_t> closest_to(const Vector2& point) const {
+            auto nearest = k_nearest(point, 1);
+            if (nearest.empty()) return std::nullopt;
 
-            return vec[_ix].val;
+            return nearest.front();
         }
-    };
 
-    template <uint8_t MaxPerNode, typename T, bool __SkipPositionCheck = false>
-        requires __SkipPositionCheck || HasPosition<T>
-    class QuadTree {
-      public:
-        // root node is always at 0 index
-        IDVec<Node> nodes;
-        IDVec<T> data;
+        // data indices of the `k` entries closest to `point`, closest first
+        // best-first search, nodes are visited in order of their distance to `point` and the search stops once the
+        // closest unvisited node is further away than the k-th closest entry found so far
+        std::vector<std::size_t> k_nearest(const Vector2& point, std::size_t k) const {
+            using Candidate = std::pair<float, Handle>;
+            using Found = std::pair<float, std::size_t>;
 
-        QuadTree(Box bbox) : nodes() {
-            nodes->emplace_back(Node(bbox));
-        };
+            std::vector<Found> found;
+            if (k == 0 || data->empty()) return {};
+            found.reserve(k + 1);
 
-        operator QuadTree<MaxPerNode, T, false>&() {
-            return reinterpret_cast<QuadTree<MaxPerNode, T, false>&>(*this);
-        }
+            auto further = [](const Candidate& a, const Candidate& b) { return a.first > b.first; };
+            std::priority_queue<Candidate, std::vector<Candidate>, decltype(further)> candidates(further);
+            candidates.emplace(distance_sqr(nodes[root].bbox, point), root);
 
-        operator QuadTree<MaxPerNode, T, true>&() {
-            return reinterpret_cast<QuadTree<MaxPerNode, T, true>&>(*this);
-        }
+            while (!candidates.empty()) {
+                auto [node_dist, handle] = candidates.top();
+                candidates.pop();
 
-        template <typename... Args> std::pair<std::size_t, uint64_t> insert(Args&&... args) {
-            data->emplace_back(std::forward<Args>(args)...);
+                // `found` is a max heap, front is the furthest of the current best
+                if (found.size() == k && node_dist > found.front().first) break;
 
-            if (!_insert(0, -1, data->size() - 1, data->back().id)) {
-                assert(false && "How???");
+                const auto& node = nodes[handle];
+                if (node.subdivided) {
+                    for (int i = 0; i < 2; i++) {
+                        for (int j = 0; j < 2; j++) {
+                            candidates.emplace(distance_sqr(nodes[node[i, j]].bbox, point), node[i, j]);
+                        }
+                    }
+
+                    continue;
+                }
+
+                for (const auto& dat : node.data) {
+                    auto data_ix = data.lookup(dat);
+                    if (!data_ix) continue;
+
+                    auto dist = distance_sqr(data.vec[*data_ix].position(), point);
+                    if (found.size() == k) {
+                        if (dist >= found.front().first) continue;
+
+                        std::ranges::pop_heap(found);
+                        found.pop_back();
+                    }
+
+                    found.emplace_back(dist, *data_ix);
+                    std::ranges::push_heap(found);
+                }
             }
 
-            return {data->size() - 1, data->back().id};
-        }
+            std::ranges::sort_heap(found);
 
-        void remove(std::size_t data_ix) {
-            if (data_ix >= data->size()) return;
+            std::vector<std::size_t> ret;
+            ret.reserve(found.size());
+            for (const auto& [_, data_ix] : found) {
+                ret.emplace_back(data_ix);
+            }
 
-            std::swap(data.vec[data_ix], data.vec.back());
-            data->pop_back();
+            return ret;
         }
 
-        void remove(std::size_t data_ix, uint64_t data_id) {
-            if (data.lookup(data_ix, data_id)) remove(data_ix);
-        }
+        float distance_sqr(const Vector2& a, const Vector2& b) const {
+            auto dx = std::abs(a.x - b.x);
+            auto dy = std::abs(a.y - b.y);
 
-        // assumes the function doesn't change position
-        void search_by(std::function<bool(const Box&)> check_box, std::function<bool(const T&)> check_data,
-                       std::function<void(T&, std::size_t)> f) {
-            search_by(0, -1, check_box, check_data, f);
-        }
+            if (toroidal) {
+                const auto& world = nodes[root].bbox;
+                dx = std::min(dx, world.max.x - world.min.x - dx);
+                dy = std::min(dy, world.max.y - world.min.y - dy);
+            }
 
-        void in_box(const Box& bbox, std::function<void(const T&, std::size_t)> f) {
-            search_by([&bbox](const Box& other) { return bbox.intersect(other); },
-                      [&bbox](const T& t) { return bbox.contains(t.position()); }, f);
+            return dx * dx + dy * dy;
         }
 
-        std::optional<node_ix> closest_to(const Vector2& point) const {
-            std::size_t closest = static_cast<std::size_t>(-1);
-            float closest_dist = -1.0f;
+        // 0 when `point` is inside `box`
+        float distance_sqr(const Box& box, const Vector2& point) const {
+            auto axis = [](float p, float min, float max) { return std::max({min - p, 0.0f, p - max}); };
 
-            for (std::size_t i = 0; i < data->size(); i++) {
-                auto dist = Vector2DistanceSqr(point, data.vec[i].val.position());
-                if (closest == static_cast<std::size_t>(-1) || closest_dist > dist) {
-                    closest = i;
-                    closest_dist = dist;
-                }
+            auto dx = axis(point.x, box.min.x, box.max.x);
+            auto dy = axis(point.y, box.min.y, box.max.y);
+
+            if (toroidal) {
+                const auto& world = nodes[root].bbox;
+                auto width = world.max.x - world.min.x;
+                auto height = world.max.y - world.min.y;
+
+                dx = std::min({dx, axis(point.x + width, box.min.x, box.max.x),
+                               axis(point.x - width, box.min.x, box.max.x)});
+                dy = std::min({dy, axis(point.y + height, box.min.y, box.max.y),
+                               axis(point.y - height, box.min.y, box.max.y)});
             }
 
-            return closest;
+            return dx * dx + dy * dy;
         }
 
         void rebuild() {
-            auto root_bbox = nodes[0, -1].bbox;
-            nodes->clear();
-            nodes->emplace_back(Node(root_bbox));
+            auto root_bbox = nodes[root].bbox;
+            nodes.clear();
+            root = nodes.emplace(root_bbox);
+            leaves.assign(data->size(), null);
+            stale = 0;
 
             for (std::size_t ix = 0; ix < data->size(); ix++) {
-                _insert(0, -1, ix, data.vec[ix].id);
+                _insert(root, data.handle_of(ix));
             }
         }
 
-        void reinsert(std::size_t data_ix) {
-            data.vec[data_ix].id = ++data.vec[data_ix].last_id;
-            _insert(0, -1, data_ix, data.vec[data_ix].id);
+        // call after changing the position of `data_ix`
+        // entries that stayed inside their leaf only cost a bbox check, the rest climb to the first ancestor that
+        // contains them and get inserted from there
+        // returns true if the entry changed leaves
+        bool update(std::size_t data_ix) {
+            auto handle = data.handle_of(data_ix);
+            const auto& position = data.vec[data_ix].position();
+
+            if (nodes.contains(leaves[data_ix])) {
+                auto& leaf = nodes[leaves[data_ix]];
+                if (leaf.bbox.contains(position)) return false;
+
+                std::erase(leaf.data, handle);
+                leaves[data_ix] = null;
+                stale++;
+
+                auto ancestor = leaf.parent;
+                while (nodes.contains(ancestor) && !nodes[ancestor].bbox.contains(position)) {
+                    ancestor = nodes[ancestor].parent;
+                }
+
+                if (nodes.contains(ancestor) && _insert(ancestor, handle)) return true;
+            }
+
+            return _insert(root, handle);
+        }
+
+        // prunes once enough entries were removed or moved between leaves, the cost of a prune is linear in the size
+        // of the tree, so this keeps it amortized over the changes that made it necessary
+        void maintain() {
+            if (stale <= std::max<std::size_t>(MaxPerNode, data->size() / 4)) return;
+
+            prune();
         }
 
         void prune() {
-            prune(0, -1);
+            prune(root);
+            stale = 0;
         }
 
         void print(std::function<void(const T&, const char*)> print_t) const {
             std::println("NODES:");
-            for (const auto& node : nodes.vec) {
-                std::println("ID: {}; VAL:", node.id);
-                std::println("\tbbox: {{ .min = [{}, {}], .max = [{}, {}] }}", node.val.bbox.min.x, node.val.bbox.min.y,
-                             node.val.bbox.max.x, node.val.bbox.max.y);
-                std::println("\tsubdivided: {}", node.val.subdivided);
+            for (std::size_t i = 0; i < nodes->size(); i++) {
+                const auto& node = nodes.vec[i];
+                auto handle = nodes.handle_of(i);
+
+                std::println("HANDLE: {}/{}; VAL:", handle.index, handle.generation);
+                std::println("\tbbox: {{ .min = [{}, {}], .max = [{}, {}] }}", node.bbox.min.x, node.bbox.min.y,
+                             node.bbox.max.x, node.bbox.max.y);
+                std::println("\tsubdivided: {}", node.subdivided);
                 std::print("\tchildren: [");
                 for (int y = 0; y < 2; y++) {
                     for (int x = 0; x < 2; x++) {
-                        std::print(" {{ [{}, {}]: ix: {}, id :{} }}", y, x, node.val[y, x].first,
-                                   node.val[y, x].second);
+                        std::print(" {{ [{}, {}]: {}/{} }}", y, x, node[y, x].index, node[y, x].generation);
                     }
                 }
                 std::println(" ]");
-                std::print("\tdata_ixs_ided: [");
-                for (const auto& [ix, id] : node.val.data_ixs_ided) {
-                    std::print(" {{ ix: {}, id: {} }}", ix, id);
+                std::print("\tdata: [");
+                for (const auto& dat : node.data) {
+                    std::print(" {}/{}", dat.index, dat.generation);
                 }
                 std::println(" ]");
             }
 
             std::println("\nDATA: ");
-            for (const auto& dat : *data) {
-                std::println("ID: {}; VAL:", dat.id);
-                std::println("\tposition: [{}, {}]", dat.val.position().x, dat.val.position().y);
+            for (std::size_t i = 0; i < data->size(); i++) {
+                auto handle = data.handle_of(i);
+
+                std::println("HANDLE: {}/{}; VAL:", handle.index, handle.generation);
+                std::println("\tposition: [{}, {}]", data.vec[i].position().x, data.vec[i].position().y);
                 std::println("\tUSER DATA:");
-                print_t(dat.val, "\t\t");
+                print_t(data.vec[i], "\t\t");
             }
         }
 
         void draw_bbs(Color col, bool two_d) {
-            draw_bbs(col, 0, -1, two_d);
+            draw_bbs(col, root, two_d);
         }
 
       private:
-        std::optional<node_ix> _insert(node_ix parent_ix, uint64_t parent_id, std::size_t dat_ix, uint64_t dat_id) {
-            const auto& parent = nodes[parent_ix, parent_id];
+        bool _insert(Handle node_handle, Handle dat) {
+            if (!nodes.contains(node_handle)) return false;
+
+            auto data_ix = *data.lookup(dat);
+            const auto& node = nodes[node_handle];
 
-            if (!parent.bbox.contains(data.vec[dat_ix].val.position())) return std::nullopt;
+            if (!node.bbox.contains(data.vec[data_ix].position())) return false;
 
-            if (!parent.subdivided && parent.data_ixs_ided.size() + 1 <= MaxPerNode) {
-                nodes[parent_ix, parent_id].data_ixs_ided.emplace_back(dat_ix, dat_id);
+            if (!node.subdivided && (node.data.size() + 1 <= MaxPerNode || node.depth == max_depth)) {
+                nodes[node_handle].data.emplace_back(dat);
+                leaves[data_ix] = node_handle;
 
-                return parent_ix;
+                return true;
             }
 
-            if (!parent.subdivided) {
-                subdivide(parent_ix, parent_id);
+            if (!node.subdivided) {
+                subdivide(node_handle);
             }
-            // AFTER this point `parent` might be invalidated, use `parent_ix`
+            // AFTER this point `node` might be invalidated, use `node_handle`
             for (int i = 0; i < 2; i++) {
                 for (int j = 0; j < 2; j++) {
-                    auto& [child_ix, child_id] = nodes[parent_ix, parent_id][i, j];
-
-                    if (auto new_ix = _insert(child_ix, child_id, dat_ix, dat_id); new_ix) {
-                        nodes[parent_ix, parent_id][i, j].first = *new_ix;
-
-                        return parent_ix;
-                    }
+                    if (_insert(nodes[node_handle][i, j], dat)) return true;
                 }
             }
 
-            return std::nullopt;
+            return false;
         }
 
-        void subdivide(node_ix ix, uint64_t ix_id) {
-            auto& parent = nodes[ix, ix_id];
+        void subdivide(Handle handle) {
+            auto& parent = nodes[handle];
             if (parent.subdivided) return;
 
             float mid_x = (parent.bbox.min.x + parent.bbox.max.x) / 2.0f;
             float mid_y = (parent.bbox.min.y + parent.bbox.max.y) / 2.0f;
+            auto depth = static_cast<uint8_t>(parent.depth + 1);
 
-#define PARENT nodes[ix, ix_id]
-            PARENT[0, 0] = add_node(Box(PARENT.bbox.min, {mid_x, mid_y}));
-            PARENT[0, 1] = add_node(Box({mid_x, PARENT.bbox.min.y}, {PARENT.bbox.max.x, mid_y}));
-            PARENT[1, 0] = add_node(Box({PARENT.bbox.min.x, mid_y}, {mid_x, PARENT.bbox.max.y}));
-            PARENT[1, 1] = add_node(Box({mid_x, mid_y}, PARENT.bbox.max));
+#define PARENT nodes[handle]
+            PARENT[0, 0] = nodes.emplace(Box(PARENT.bbox.min, {mid_x, mid_y}), handle, depth);
+            PARENT[0, 1] = nodes.emplace(Box({mid_x, PARENT.bbox.min.y}, {PARENT.bbox.max.x, mid_y}), handle, depth);
+            PARENT[1, 0] = nodes.emplace(Box({PARENT.bbox.min.x, mid_y}, {mid_x, PARENT.bbox.max.y}), handle, depth);
+            PARENT[1, 1] = nodes.emplace(Box({mid_x, mid_y}, PARENT.bbox.max), handle, depth);
 
-            for (const auto& [_data_ix, id] : PARENT.data_ixs_ided) {
-                auto data_ix = _data_ix;
-                if (!data.lookup(data_ix, id)) {
-                    continue;
-                }
+            for (const auto& dat : PARENT.data) {
+                auto data_ix = data.lookup(dat);
+                if (!data_ix) continue;
 
-                const auto& pos = data.vec[data_ix].val.position();
+                const auto& pos = data.vec[*data_ix].position();
+                auto child = PARENT[pos.y < mid_y ? 0 : 1, pos.x < mid_x ? 0 : 1];
 
-                if (pos.y < mid_y) {
-                    if (pos.x < mid_x) {
-                        nodes[PARENT[0, 0].first, PARENT[0, 0].second].data_ixs_ided.emplace_back(data_ix, id);
-                    } else {
-                        nodes[PARENT[0, 1].first, PARENT[0, 0].second].data_ixs_ided.emplace_back(data_ix, id);
-                    }
-                } else {
-                    if (pos.x < mid_x) {
-                        nodes[PARENT[1, 0].first, PARENT[0, 0].second].data_ixs_ided.emplace_back(data_ix, id);
-                    } else {
-                        nodes[PARENT[1, 1].first, PARENT[0, 0].second].data_ixs_ided.emplace_back(data_ix, id);
-                    }
-                }
+                nodes[child].data.emplace_back(dat);
+                leaves[*data_ix] = child;
             }
 
-            PARENT.data_ixs_ided.clear();
-            PARENT.data_ixs_ided.shrink_to_fit();
+            PARENT.data.clear();
+            PARENT.data.shrink_to_fit();
             PARENT.subdivided = true;
 #undef PARENT
         }
 
-        std::pair<node_ix, uint64_t> add_node(Box&& bbox) {
-            nodes->emplace_back(bbox);
-
-            return {nodes->size() - 1, nodes->back().id};
-        }
-
-        // assumes `ix` is valid
-        void search_by(node_ix ix, uint64_t ix_id, std::function<bool(const Box&)> check_box,
-                       std::function<bool(const T&)> check_point, std::function<void(T&, std::size_t)> f) {
-            auto& node = nodes[ix, ix_id];
-
-            if (!check_box(node.bbox)) return;
-
-            if (!node.subdivided) {
-                for (auto& [data_ix, data_id] : node.data_ixs_ided) {
-                    if (!data.lookup(data_ix, data_id)) continue;
-
-                    if (check_point(data.vec[data_ix].val)) {
-                        f(data.vec[data_ix].val, data_ix);
-                    }
-                }
-
-                return;
-            }
-
-            for (int x = 0; x < 2; x++) {
-                for (int y = 0; y < 2; y++) {
-                    auto& [child_ix, child_id] = node[x, y];
-
-                    search_by(child_ix, child_id, check_box, check_point, f);
-                }
-            }
-
-        }
-
-        std::size_t prune(node_ix ix, uint64_t ix_id) {
-            {
-                std::size_t i = 0;
-                while (i < nodes[ix, ix_id].data_ixs_ided.size()) {
-                    auto& [data_ix, data_id] = nodes[ix, ix_id].data_ixs_ided[i];
-                    if (!data.lookup(data_ix, data_id)) {
-
-                        std::swap(nodes[ix, ix_id].data_ixs_ided[i], nodes[ix, ix_id].data_ixs_ided.back());
-                        nodes[ix, ix_id].data_ixs_ided.pop_back();
-                        continue;
-                    }
-
-                    i++;
-                }
-            }
+        std::size_t prune(Handle handle) {
+            std::erase_if(nodes[handle].data, [this](const Handle& dat) { return !data.contains(dat); });
 
-            auto size = nodes[ix, ix_id].data_ixs_ided.size();
-            if (!nodes[ix, ix_id].subdivided) return size;
+            auto size = nodes[handle].data.size();
+            if (!nodes[handle].subdivided) return size;
 
             bool all_leaf = true;
             std::size_t children_size = 0;
             for (int i = 0; i < 2; i++) {
                 for (int j = 0; j < 2; j++) {
-                    auto& [child_ix, child_id] = nodes[ix, ix_id][i, j];
+                    auto child = nodes[handle][i, j];
 
-                    children_size += prune(child_ix, child_id);
-                    if (nodes[child_ix, child_id].subdivided) all_leaf = false;
+                    children_size += prune(child);
+                    if (nodes[child].subdivided) all_leaf = false;
                 }
             }
 
@@ -479,34 +644,26 @@ namespace quadtree {
                 return total_size;
             }
 
-            nodes[ix, ix_id].data_ixs_ided.reserve(total_size);
             for (int i = 0; i < 2; i++) {
                 for (int j = 0; j < 2; j++) {
-                    auto& [child_ix, child_id] = nodes[ix, ix_id][i, j];
-                    auto& child = nodes[child_ix, child_id];
-                    nodes[ix, ix_id].data_ixs_ided.insert(nodes[ix, ix_id].data_ixs_ided.end(),
-                                                          child.data_ixs_ided.begin(), child.data_ixs_ided.end());
-                    bool moved = nodes->back().id == ix_id;
-
-                    if (!nodes.lookup(child_ix, child_id)) {
-                        assert(false);
-                    }
-                    std::swap(nodes.vec[child_ix], nodes.vec.back());
-                    nodes->pop_back();
+                    auto child = std::exchange(nodes[handle][i, j], null);
+                    auto entries = std::move(nodes[child].data);
+                    nodes.remove_at(*nodes.lookup(child));
 
-                    if (moved) {
-                        ix = child_ix;
+                    for (const auto& dat : entries) {
+                        leaves[*data.lookup(dat)] = handle;
                     }
-                    nodes[ix, ix_id][i, j] = {null, -1};
+                    auto& node = nodes[handle];
+                    node.data.insert(node.data.end(), entries.begin(), entries.end());
                 }
             }
 
-            nodes[ix, ix_id].subdivided = false;
+            nodes[handle].subdivided = false;
             return total_size;
         }
 
-        void draw_bbs(Color col, node_ix ix, uint64_t ix_id, bool two_d) {
-            auto& node = nodes[ix, ix_id];
+        void draw_bbs(Color col, Handle handle, bool two_d) {
+            auto& node = nodes[handle];
 
             node.bbox.draw(col, two_d);
 
@@ -514,9 +671,7 @@ namespace quadtree {
 
             for (int i = 0; i < 2; i++) {
                 for (int j = 0; j < 2; j++) {
-                    auto& [child_ix, child_id] = node[i, j];
-
-                    draw_bbs(col, child_ix, child_id, two_d);
+                    draw_bbs(col, node[i, j], two_d);
                 }
             }
         }
@@ -21,10 +21,10 @@ int main(void) {
         BeginDrawing();
 
         ClearBackground(WHITE);
-        for (const auto& p : *qt.data) {
-            auto pos = p.val.position();
+        for (std::size_t i = 0; i < qt.data->size(); i++) {
+            auto pos = qt.data.vec[i].position();
             DrawCircleV(pos, 20.0f, BLACK);
-            DrawText(std::format("{}", p.id).c_str(), pos.x, pos.y, 5, WHITE);
+            DrawText(std::format("{}", qt.data.handle_of(i).index).c_str(), pos.x, pos.y, 5, WHITE);
         }
         qt.draw_bbs(RED, true);
 
@@ -36,7 +36,7 @@ int main(void) {
             qt.insert(quadtree::pos(pos, (uint8_t)0));
         } else if (IsKeyPressed(KEY_D)) {
             for (std::size_t i = 0; i < qt.data->size(); i++) {
-                if (CheckCollisionPointCircle(GetMousePosition(), (*qt.data)[i].val.position(), 20.0f)) {
+                if (CheckCollisionPointCircle(GetMousePosition(), (*qt.data)[i].position(), 20.0f)) {
                     qt.remove(i);
                     break;
                 }
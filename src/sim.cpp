@@ -0,0 +1,369 @@
+#include "sim.hpp"
+
+#include "particle/effects.hpp"
+#include "power_up.hpp"
+#include "profiler.hpp"
+#include "utility.hpp"
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    // floats go in as their bits, a replay has to get exactly what was recorded
+    void serialize_float(float f, std::ostream& out) {
+        seria_deser::serialize(std::bit_cast<uint32_t>(f), out);
+    }
+
+    float deserialize_float(std::istream& in, version v) {
+        return std::bit_cast<float>(seria_deser::deserialize<uint32_t>(in, v));
+    }
+
+    void serialize_vector(Vector2 vec, std::ostream& out) {
+        serialize_float(vec.x, out);
+        serialize_float(vec.y, out);
+    }
+
+    Vector2 deserialize_vector(std::istream& in, version v) {
+        auto x = deserialize_float(in, v);
+        auto y = deserialize_float(in, v);
+        return {x, y};
+    }
+
+    // FNV-1a
+    struct Hasher {
+        uint64_t hash = 14695981039346656037ull;
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void add(const T& t) {
+            auto bytes = std::bit_cast<std::array<unsigned char, sizeof(T)>>(t);
+            for (auto byte : bytes) {
+                hash = (hash ^ byte) * 1099511628211ull;
+            }
+        }
+    };
+
+    uint64_t seed_rng(std::optional<uint64_t> seed) {
+        if (seed) rng::seed(*seed);
+        return rng::seed();
+    }
+
+    // anywhere in the arena except right on top of the player
+    Vector2 random_position(rng::Stream stream, Vector2 player, float clearance) {
+        std::uniform_real_distribution<float> x(arena::arena_rec.x, arena::arena_rec.x + ARENA_WIDTH);
+        std::uniform_real_distribution<float> y(arena::arena_rec.y, arena::arena_rec.y + ARENA_HEIGHT);
+
+        while (true) {
+            Vector2 pos = {x(rng::get(stream)), y(rng::get(stream))};
+            if (Vector2Distance(pos, player) >= clearance) return pos;
+        }
+    }
+}
+
+namespace sim {
+    void cast(uint8_t slot, Vector2 target, Player& player, PlayerSave& save, Enemies& enemies,
+              caster::Caster& caster) {
+        auto spell_id = player.can_cast(slot, save.get_spellbook());
+        save.cast_spell(spell_id, xz_component(player.position), target, enemies, caster, player.mana);
+    }
+
+    Outcome tick(const Input& input, Player& player, PlayerSave& save, Enemies& enemies, ItemDrops& item_drops,
+                 caster::Caster& caster, uint64_t& souls) {
+        profiler::Scope zone("sim::tick");
+        Outcome outcome;
+
+        player.tick(input.movement, input.angle);
+        save.tick_spellbook();
+
+        auto damage_done = enemies.tick(player.hitbox);
+        souls += enemies.take_souls();
+        if (player.health <= damage_done) {
+            player.health = 0;
+        } else {
+            player.health -= damage_done;
+            outcome.leveled_up = player.add_exp(enemies.take_exp());
+        }
+
+        caster.tick(save.get_spellbook(), enemies, item_drops);
+
+        item_drops.pickup(player.hitbox, [&](auto&& arg) {
+            using Item = std::decay_t<decltype(arg)>;
+
+            if constexpr (std::is_same_v<Item, Spell>) {
+                save.add_spell_to_spellbook(std::move(arg));
+                outcome.picked_up_spells++;
+            }
+        });
+
+        outcome.died = player.health == 0;
+        return outcome;
+    }
+
+    void Scenario::serialize(std::ostream& out) const {
+        seria_deser::serialize(enemies, out);
+        seria_deser::serialize(spells, out);
+        seria_deser::serialize(item_drops, out);
+    }
+
+    Scenario Scenario::deserialize(std::istream& in, version v) {
+        Scenario scenario;
+        scenario.enemies = seria_deser::deserialize<uint32_t>(in, v);
+        scenario.spells = seria_deser::deserialize<uint32_t>(in, v);
+        scenario.item_drops = seria_deser::deserialize<uint32_t>(in, v);
+
+        return scenario;
+    }
+
+    void Frame::serialize(std::ostream& out) const {
+        seria_deser::serialize(events.size(), out);
+        for (const auto& event : events) {
+            seria_deser::serialize(static_cast<uint8_t>(event.index()), out);
+            std::visit(
+                [&](auto&& arg) {
+                    using E = std::decay_t<decltype(arg)>;
+
+                    if constexpr (std::is_same_v<E, event::Cast>) {
+                        seria_deser::serialize(arg.slot, out);
+                        serialize_vector(arg.target, out);
+                    } else if constexpr (std::is_same_v<E, event::Equip>) {
+                        seria_deser::serialize(arg.spell, out);
+                        seria_deser::serialize(arg.slot, out);
+                    } else if constexpr (std::is_same_v<E, event::LevelUp>) {
+                        seria_deser::serialize(arg.choice, out);
+                    }
+                },
+                event);
+        }
+
+        serialize_vector(input.movement, out);
+        serialize_float(input.angle, out);
+        seria_deser::serialize(checksum, out);
+    }
+
+    Frame Frame::deserialize(std::istream& in, version v) {
+        Frame frame;
+
+        auto event_count = seria_deser::deserialize<std::size_t>(in, v);
+        for (std::size_t i = 0; i < event_count && in; i++) {
+            switch (seria_deser::deserialize<uint8_t>(in, v)) {
+                case 0: {
+                    auto slot = seria_deser::deserialize<uint8_t>(in, v);
+                    frame.events.emplace_back(event::Cast{.slot = slot, .target = deserialize_vector(in, v)});
+                    break;
+                }
+                case 1: {
+                    auto spell = seria_deser::deserialize<uint64_t>(in, v);
+                    frame.events.emplace_back(
+                        event::Equip{.spell = spell, .slot = seria_deser::deserialize<uint8_t>(in, v)});
+                    break;
+                }
+                case 2:
+                    frame.events.emplace_back(event::LevelUp{.choice = seria_deser::deserialize<uint8_t>(in, v)});
+                    break;
+                default:
+                    in.setstate(std::ios::failbit);
+                    break;
+            }
+        }
+
+        frame.input.movement = deserialize_vector(in, v);
+        frame.input.angle = deserialize_float(in, v);
+        frame.checksum = seria_deser::deserialize<uint64_t>(in, v);
+
+        return frame;
+    }
+
+    void Recording::serialize(std::ostream& out) const {
+        seria_deser::serialize(CURRENT_VERSION, out);
+        seria_deser::serialize(seed, out);
+        seria_deser::serialize(max_enemies, out);
+        seria_deser::serialize(god, out);
+        seria_deser::serialize(scenario, out);
+        seria_deser::serialize(frames, out);
+    }
+
+    std::optional<Recording> Recording::deserialize(std::istream& in) {
+        auto v = seria_deser::deserialize_version(in);
+        if (!in || v == 0 || v > CURRENT_VERSION) return std::nullopt;
+
+        Recording recording;
+        recording.seed = seria_deser::deserialize<uint64_t>(in, v);
+        recording.max_enemies = seria_deser::deserialize<uint32_t>(in, v);
+        recording.god = seria_deser::deserialize<bool>(in, v);
+        if (v >= 2) recording.scenario = seria_deser::deserialize<Scenario>(in, v);
+
+        // not `seria_deser::deserialize<std::vector<Frame>>`, a cut off file would have it read garbage for a while
+        auto frame_count = seria_deser::deserialize<std::size_t>(in, v);
+        for (std::size_t i = 0; i < frame_count && in; i++) {
+            recording.frames.emplace_back(Frame::deserialize(in, v));
+        }
+
+        if (!in) return std::nullopt;
+        return recording;
+    }
+
+    World::World(uint32_t max_enemies, std::optional<uint64_t> new_seed)
+        : seed(seed_rng(new_seed)), player(Vector3Zero()), enemies(max_enemies) {
+        save.create_default_spell();
+        player.equip_spell(0, 0, save.get_spellbook());
+    }
+
+    void World::record() {
+        assert(ticks == 0 && "Recording has to start with the run");
+
+        recording = Recording{
+            .seed = seed,
+            .max_enemies = enemies.max_cap,
+            .god = god,
+            .scenario = scenario,
+            .frames = {},
+        };
+    }
+
+    void World::populate(const Scenario& new_scenario) {
+        assert(ticks == 0 && !recording && "A scenario has to be set up before the run starts");
+
+        scenario = new_scenario;
+        auto center = xz_component(player.position);
+
+        for (uint32_t i = 0; i < scenario.enemies; i++) {
+            // there's always enough cap for every kind of enemy, it only gets counted
+            auto enemy = enemies::random_enemy(std::numeric_limits<uint32_t>::max(), enemies.cap);
+            auto pos = random_position(rng::Stream::Spawner, center, Player::visibility_radius / 2.0f);
+            auto lvl = static_cast<uint16_t>(rng::value(rng::Stream::Spawner, 1, 3));
+
+            enemies.enemies.insert(pos, lvl, false, std::move(*enemy));
+        }
+        // whatever dies gets replaced, one at a time like the spawner always does
+        enemies.max_cap = std::max(enemies.max_cap, enemies.cap);
+        enemies.cap_limit = std::max(enemies.cap_limit, enemies.max_cap);
+
+        for (uint32_t i = 0; i < scenario.spells; i++) {
+            storm.emplace_back(save.add_spell_to_spellbook(Spell::random(10)));
+        }
+
+        for (uint32_t i = 0; i < scenario.item_drops; i++) {
+            auto level = static_cast<uint32_t>(rng::value(rng::Stream::Drops, 1, 10));
+            item_drops.add_item_drop(level, random_position(rng::Stream::Drops, center, ItemDrops::hitbox_radius * 4));
+        }
+    }
+
+    void World::cast(uint8_t slot, Vector2 target) {
+        if (recording) pending_events.emplace_back(event::Cast{.slot = slot, .target = target});
+
+        sim::cast(slot, target, player, save, enemies, caster);
+    }
+
+    void World::equip(uint64_t spell, uint8_t slot) {
+        if (recording) pending_events.emplace_back(event::Equip{.spell = spell, .slot = slot});
+
+        player.equip_spell(spell, slot, save.get_spellbook());
+    }
+
+    void World::level_up(uint8_t choice) {
+        if (recording) pending_events.emplace_back(event::LevelUp{.choice = choice});
+
+        // all three get rolled even though only one is kept, same as the level up screen
+        std::array<PowerUp, 3> power_ups{PowerUp::random(), PowerUp::random(), PowerUp::random()};
+        player.add_power_up(std::move(power_ups[choice % power_ups.size()]));
+    }
+
+    Outcome World::tick(const Input& input) {
+        // spread out all the way around the player, the storm is supposed to hit everywhere
+        static constexpr float golden_angle = 2.39996323f;
+
+        auto center = xz_component(player.position);
+        for (std::size_t i = 0; i < storm.size(); i++) {
+            if (save.get_spellbook()[storm[i]].current_cooldown != 0) continue;
+
+            auto angle = static_cast<float>(i) * golden_angle;
+            auto target = center + Vector2{std::cos(angle), std::sin(angle)} * 100.0f;
+            uint64_t mana = std::numeric_limits<uint64_t>::max();
+            save.cast_spell(storm[i], center, target, enemies, caster, mana);
+        }
+
+        auto outcome = sim::tick(input, player, save, enemies, item_drops, caster, souls);
+        effects::update(1.0f / TICKS);
+        ticks++;
+
+        if (outcome.died && god) player.health = player.stats.max_health.get();
+
+        if (recording) {
+            recording->frames.emplace_back(Frame{
+                .events = std::exchange(pending_events, {}),
+                .input = input,
+                .checksum = checksum(),
+            });
+        }
+
+        return outcome;
+    }
+
+    uint64_t World::checksum() const {
+        Hasher hasher;
+
+        hasher.add(player.total_position);
+        hasher.add(player.health);
+        hasher.add(player.mana);
+        hasher.add(player.lvl);
+        hasher.add(player.exp);
+        hasher.add(souls);
+        hasher.add(enemies.killed);
+
+        auto enemy_count = enemies.enemies.size();
+        hasher.add(enemy_count);
+        for (std::size_t i = 0; i < enemy_count; i++) {
+            hasher.add(enemies.enemies.position(i));
+        }
+
+        return hasher.hash;
+    }
+
+    std::size_t World::active_spells() {
+        std::size_t count = 0;
+        caster.world.make_system<const spell_slot>().run([&](const spell_slot&) { count++; });
+
+        return count;
+    }
+
+    std::size_t World::lying_item_drops() {
+        std::size_t count = 0;
+        item_drops.world.make_system<const effects::Id>().run([&](const effects::Id&) { count++; });
+
+        return count;
+    }
+
+    std::optional<uint64_t> replay(const Recording& recording) {
+        World world(recording.max_enemies, recording.seed);
+        world.god = recording.god;
+        world.populate(recording.scenario);
+
+        for (const auto& frame : recording.frames) {
+            for (const auto& event : frame.events) {
+                std::visit(
+                    [&](auto&& arg) {
+                        using E = std::decay_t<decltype(arg)>;
+
+                        if constexpr (std::is_same_v<E, event::Cast>) {
+                            world.cast(arg.slot, arg.target);
+                        } else if constexpr (std::is_same_v<E, event::Equip>) {
+                            world.equip(arg.spell, arg.slot);
+                        } else if constexpr (std::is_same_v<E, event::LevelUp>) {
+                            world.level_up(arg.choice);
+                        }
+                    },
+                    event);
+            }
+
+            world.tick(frame.input);
+            if (world.checksum() != frame.checksum) return world.ticks - 1;
+        }
+
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "enemies_spawner.hpp"
+#include "item_drops.hpp"
+#include "player.hpp"
+#include "seria_deser.hpp"
+#include "spell_caster.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <variant>
+#include <vector>
+
+// the part of the arena that runs on the fixed tick, `Arena::update` and the headless `manalter_sim` both go through
+// it, nothing in here needs a window, a gl context or the disk
+namespace sim {
+    // what the player does in a tick, minus casting
+    struct Input {
+        // normalized, zero when standing still
+        Vector2 movement = {0.0f, 0.0f};
+        float angle = 0.0f;
+    };
+
+    struct Outcome {
+        bool leveled_up = false;
+        bool died = false;
+        // already in the spellbook
+        std::size_t picked_up_spells = 0;
+    };
+
+    // casts whatever is equipped in `slot` towards `target`, if it's off cooldown and there's enough mana
+    void cast(uint8_t slot, Vector2 target, Player& player, PlayerSave& save, Enemies& enemies, caster::Caster& caster);
+
+    // the player moves, enemies move, spawn and hit, spells hit, items get picked up
+    Outcome tick(const Input& input, Player& player, PlayerSave& save, Enemies& enemies, ItemDrops& item_drops,
+                 caster::Caster& caster, uint64_t& souls);
+
+    // load put on a fresh `World` on top of what a normal run has, for finding out how far things scale
+    struct Scenario {
+        // spread over the whole arena, the spawner keeps the crowd at this size as they die
+        uint32_t enemies = 0;
+        // random spells, every one of them is cast whenever it's off cooldown, mana doesn't matter
+        uint32_t spells = 0;
+        // random spells lying around the arena
+        uint32_t item_drops = 0;
+
+        void serialize(std::ostream& out) const;
+        static Scenario deserialize(std::istream& in, version v);
+    };
+
+    // everything a `World` gets told to do, besides its inputs everything else comes from the seed
+    namespace event {
+        struct Cast {
+            uint8_t slot;
+            Vector2 target;
+        };
+
+        struct Equip {
+            uint64_t spell;
+            uint8_t slot;
+        };
+
+        // index into the power ups the level up screen would've offered
+        struct LevelUp {
+            uint8_t choice;
+        };
+    }
+
+    using Event = std::variant<event::Cast, event::Equip, event::LevelUp>;
+
+    // one tick of a run, `events` happened before it and `checksum` is what `World::checksum` was after it
+    struct Frame {
+        std::vector<Event> events;
+        Input input;
+        uint64_t checksum;
+
+        void serialize(std::ostream& out) const;
+        static Frame deserialize(std::istream& in, version v);
+    };
+
+    // enough to play a run again on the same build, tick for tick
+    struct Recording {
+        // bumped whenever the layout below changes, it's unrelated to the save's version
+        static constexpr version CURRENT_VERSION = 2;
+
+        uint64_t seed;
+        uint32_t max_enemies;
+        bool god;
+        // since version 2
+        Scenario scenario;
+        std::vector<Frame> frames;
+
+        void serialize(std::ostream& out) const;
+        // nullopt if the version isn't known or the stream ends early
+        static std::optional<Recording> deserialize(std::istream& in);
+    };
+
+    // an arena without the scene around it, starts out like a fresh run with only the default spell equipped
+    // the save is never written, so the real one is safe
+    struct World {
+        // what the streams in `rng` got seeded with
+        uint64_t seed;
+        Player player;
+        PlayerSave save;
+        Enemies enemies;
+        ItemDrops item_drops;
+        caster::Caster caster;
+        uint64_t souls = 0;
+        uint64_t ticks = 0;
+        // the player never dies, health fills back up instead
+        bool god = false;
+        // only there after `record`
+        std::optional<Recording> recording;
+        // set by `populate`
+        Scenario scenario;
+        // spellbook indices of the scenario's spells
+        std::vector<uint64_t> storm;
+
+        // reseeds `rng` when given a seed, otherwise keeps going with whatever it's at
+        World(uint32_t max_enemies = 100, std::optional<uint64_t> seed = std::nullopt);
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        // has to be called before the first tick, the seed has to come from the constructor too
+        void record();
+        // has to be called before the first tick and before `record`
+        void populate(const Scenario& new_scenario);
+
+        void cast(uint8_t slot, Vector2 target);
+        void equip(uint64_t spell, uint8_t slot);
+        // what the level up screen does, three power ups get rolled and `choice` gets added to the player
+        void level_up(uint8_t choice);
+        // also steps the particle effects, nobody else is going to
+        Outcome tick(const Input& input);
+
+        // hash of what the player can see of the run, if two of these are equal the runs haven't split yet
+        uint64_t checksum() const;
+
+        std::size_t active_spells();
+        std::size_t lying_item_drops();
+
+      private:
+        std::vector<Event> pending_events;
+    };
+
+    // plays `recording` back as fast as possible, returns the first tick whose checksum doesn't match
+    std::optional<uint64_t> replay(const Recording& recording);
+}
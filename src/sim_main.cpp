@@ -0,0 +1,299 @@
+#include <raylib.h>
+
+#include "particle/effects.hpp"
+#include "profiler.hpp"
+#include "sim.hpp"
+#include "utility.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <print>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// runs the arena as fast as it goes, no window, no gpu, the player follows a script instead of the keyboard
+//
+// usage: manalter_sim [--ticks N] [--enemies N] [--script FILE] [--god] [--seed N] [--record FILE] [--trace FILE]
+//                     [--crowd N] [--storm N] [--drops N]
+//        manalter_sim --replay FILE
+//
+// a script is one step per line, every step holds from its tick until the next one starts:
+//     <tick> <move x> <move y> <slots to cast, comma separated, or ->
+// empty lines and lines starting with # get skipped
+// without a script the player walks around in circles and casts everything it has
+//
+// --record writes every input of the run to FILE, --replay plays it back and checks that every tick ends up exactly
+// where it did the first time, it exits with 1 as soon as one doesn't
+//
+// --trace profiles every tick and writes the last `profiler::history_size` of them to FILE as a chrome trace
+//
+// --crowd, --storm and --drops set up a `sim::Scenario` to stress the arena with, e.g. 50k enemies, 300 spells going
+// off all the time and 5k item drops lying around:
+//     manalter_sim --god --ticks 3000 --crowd 50000 --storm 300 --drops 5000
+// the tick time percentiles at the end are what to look at
+
+namespace {
+    struct Step {
+        uint64_t tick;
+        Vector2 movement;
+        // every tick, whenever they're ready
+        std::vector<uint8_t> casts;
+    };
+
+    std::optional<std::vector<Step>> load_script(const char* path) {
+        std::ifstream file(path);
+        if (!file) return std::nullopt;
+
+        std::vector<Step> steps;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line.starts_with('#')) continue;
+
+            Step step;
+            std::string casts;
+            std::istringstream in(line);
+            if (!(in >> step.tick >> step.movement.x >> step.movement.y >> casts)) return std::nullopt;
+
+            if (casts != "-") {
+                std::istringstream slots(casts);
+                std::string slot;
+                while (std::getline(slots, slot, ',')) {
+                    step.casts.emplace_back(static_cast<uint8_t>(std::stoul(slot)));
+                }
+            }
+
+            steps.emplace_back(std::move(step));
+        }
+
+        std::ranges::sort(steps, {}, &Step::tick);
+        return steps;
+    }
+
+    // a new direction every 2 seconds, all the way around
+    std::vector<Step> default_script() {
+        std::vector<Step> steps;
+        for (uint64_t i = 0; i < 8; i++) {
+            auto angle = static_cast<float>(i) * PI / 4.0f;
+            steps.emplace_back(Step{
+                .tick = i * 2 * TICKS,
+                .movement = {std::cos(angle), std::sin(angle)},
+                .casts = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+            });
+        }
+        return steps;
+    }
+
+    const Step& step_at(const std::vector<Step>& script, uint64_t tick) {
+        auto it = std::ranges::upper_bound(script, tick, {}, &Step::tick);
+        return it == script.begin() ? script.front() : *std::prev(it);
+    }
+
+    // what the level up screen and the spellbook would've done, the first power up and every free slot gets a spell
+    void handle_progression(sim::World& world, const sim::Outcome& outcome) {
+        if (outcome.leveled_up) world.level_up(0);
+
+        const auto& spellbook = world.save.get_spellbook();
+        for (uint8_t slot = 0; slot < world.player.unlocked_spell_count; slot++) {
+            if (world.player.get_equipped_spell(slot) != std::numeric_limits<uint64_t>::max()) continue;
+
+            for (uint64_t spell = 0; spell < spellbook.size(); spell++) {
+                auto equipped = std::span(world.player.equipped_spells.get(), world.player.unlocked_spell_count);
+                if (std::ranges::find(equipped, spell) != equipped.end()) continue;
+
+                world.equip(spell, slot);
+                break;
+            }
+        }
+    }
+
+    // nearest rank, `sorted` can't be empty
+    double percentile(const std::vector<double>& sorted, double p) {
+        auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    template <typename T> bool parse(std::string_view arg, T& out) {
+        auto [_, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), out);
+        return ec == std::errc();
+    }
+
+    int replay(const char* path) {
+        std::ifstream file(path, std::ios::binary);
+        auto recording = sim::Recording::deserialize(file);
+        if (!recording) {
+            std::println(stderr, "couldn't read a recording from {}", path);
+            return 1;
+        }
+
+        SetTraceLogLevel(LOG_WARNING);
+
+        auto start = std::chrono::steady_clock::now();
+        auto diverged_at = sim::replay(*recording);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        effects::clean();
+
+        std::println("ticks:        {}", recording->frames.size());
+        std::println("wall time:    {:.3f}s", elapsed.count());
+        std::println("ticks/s:      {:.0f}", static_cast<double>(recording->frames.size()) / elapsed.count());
+        if (diverged_at) {
+            std::println("diverged at:  tick {}", *diverged_at);
+            return 1;
+        }
+
+        std::println("replay matches");
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t ticks = 10'000;
+    uint32_t max_enemies = 100;
+    bool god = false;
+    std::optional<uint64_t> seed;
+    const char* record_path = nullptr;
+    const char* trace_path = nullptr;
+    sim::Scenario scenario;
+    std::optional<std::vector<Step>> script;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--ticks" && has_value && parse(argv[++i], ticks)) continue;
+        if (arg == "--enemies" && has_value && parse(argv[++i], max_enemies)) continue;
+        if (arg == "--script" && has_value) {
+            script = load_script(argv[++i]);
+            if (script && !script->empty()) continue;
+
+            std::println(stderr, "couldn't read a script from {}", argv[i]);
+            return 1;
+        }
+        if (arg == "--god") {
+            god = true;
+            continue;
+        }
+        if (arg == "--seed" && has_value && parse(argv[++i], seed.emplace())) continue;
+        if (arg == "--record" && has_value) {
+            record_path = argv[++i];
+            continue;
+        }
+        if (arg == "--trace" && has_value) {
+            trace_path = argv[++i];
+            continue;
+        }
+        if (arg == "--crowd" && has_value && parse(argv[++i], scenario.enemies)) continue;
+        if (arg == "--storm" && has_value && parse(argv[++i], scenario.spells)) continue;
+        if (arg == "--drops" && has_value && parse(argv[++i], scenario.item_drops)) continue;
+        if (arg == "--replay" && has_value && argc == 3) return replay(argv[++i]);
+
+        std::println(stderr,
+                     "usage: {} [--ticks N] [--enemies N] [--script FILE] [--god] [--seed N] [--record FILE] "
+                     "[--trace FILE]",
+                     argv[0]);
+        std::println(stderr, "       {:{}} [--crowd N] [--storm N] [--drops N]", "", std::string_view(argv[0]).size());
+        std::println(stderr, "       {} --replay FILE", argv[0]);
+        return 1;
+    }
+
+    // the default script loops, a loaded one stays on its last step
+    bool looping = !script;
+    if (!script) script = default_script();
+    auto script_length = script->back().tick + 2 * TICKS;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    sim::World world(max_enemies, seed);
+    world.god = god;
+    world.populate(scenario);
+    if (record_path) world.record();
+    profiler::enable(trace_path != nullptr);
+    std::optional<uint64_t> died_at;
+
+    // in milliseconds
+    std::vector<double> tick_times;
+    tick_times.reserve(ticks);
+    std::size_t peak_enemies = 0;
+    std::size_t peak_spells = 0;
+    std::size_t peak_item_drops = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (world.ticks < ticks) {
+        auto tick_start = std::chrono::steady_clock::now();
+        profiler::begin_frame();
+        const auto& step = step_at(*script, looping ? world.ticks % script_length : world.ticks);
+
+        // same as the keyboard, only pressed keys cast and the mouse is wherever the player is heading
+        auto target = xz_component(world.player.position) + step.movement * 100.0f;
+        for (auto slot : step.casts) {
+            world.cast(slot, target);
+        }
+
+        auto angle = std::atan2(step.movement.y, step.movement.x) * RAD2DEG;
+        auto outcome = world.tick(sim::Input{
+            .movement = step.movement,
+            .angle = angle,
+        });
+        handle_progression(world, outcome);
+        profiler::end_frame();
+
+        std::chrono::duration<double, std::milli> tick_time = std::chrono::steady_clock::now() - tick_start;
+        tick_times.emplace_back(tick_time.count());
+        peak_enemies = std::max(peak_enemies, world.enemies.enemies.size());
+        peak_spells = std::max(peak_spells, world.active_spells());
+        peak_item_drops = std::max(peak_item_drops, world.lying_item_drops());
+
+        if (outcome.died && !god) {
+            died_at = world.ticks;
+            break;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::println("seed:         {}", world.seed);
+    std::println("ticks:        {}", world.ticks);
+    std::println("game time:    {:.1f}s", static_cast<double>(world.ticks) / TICKS);
+    std::println("wall time:    {:.3f}s", elapsed.count());
+    std::println("ticks/s:      {:.0f}", static_cast<double>(world.ticks) / elapsed.count());
+    std::println("enemies:      {} alive, {} killed", world.enemies.enemies.size(), world.enemies.killed);
+    std::println("player:       lvl {}, {} hp, {} spells", world.player.lvl, world.player.health,
+                 world.save.get_spellbook().size());
+    if (died_at) std::println("died at tick: {}", *died_at);
+    std::println("peak load:    {} enemies, {} spells in flight, {} item drops", peak_enemies, peak_spells,
+                 peak_item_drops);
+    if (!tick_times.empty()) {
+        std::ranges::sort(tick_times);
+        std::println("tick time:    p50 {:.3f} ms, p90 {:.3f} ms, p99 {:.3f} ms, p99.9 {:.3f} ms, max {:.3f} ms",
+                     percentile(tick_times, 50.0), percentile(tick_times, 90.0), percentile(tick_times, 99.0),
+                     percentile(tick_times, 99.9), tick_times.back());
+        std::println("over budget:  {} of {} ticks took longer than {:.2f} ms",
+                     std::ranges::count_if(tick_times, [](double t) { return t > 1000.0 / TICKS; }),
+                     tick_times.size(), 1000.0 / TICKS);
+    }
+
+    if (record_path) {
+        std::ofstream file(record_path, std::ios::binary);
+        world.recording->serialize(file);
+        if (!file) {
+            std::println(stderr, "couldn't write the recording to {}", record_path);
+            return 1;
+        }
+    }
+
+    if (trace_path && !profiler::export_chrome_trace(trace_path)) {
+        std::println(stderr, "couldn't write the trace to {}", trace_path);
+        return 1;
+    }
+
+    effects::clean();
+
+    return 0;
+}
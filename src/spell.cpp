@@ -107,8 +107,9 @@ Spell Spell::random(uint32_t max_level) {
     static std::discrete_distribution<uint8_t> dist({54, 28, 12, 5, 1});
 
     return Spell(
-        spells::create_spell(static_cast<spells::Tag>(GetRandomValue(0, static_cast<int>(spells::Tag::Size) - 1))),
-        static_cast<Rarity>(dist(rng::get())), levelDist(rng::get()));
+        spells::create_spell(
+            static_cast<spells::Tag>(rng::value(rng::Stream::Spells, 0, static_cast<int>(spells::Tag::Size) - 1))),
+        static_cast<Rarity>(dist(rng::get(rng::Stream::Spells))), levelDist(rng::get(rng::Stream::Spells)));
 }
 
 void Spell::serialize(std::ostream& out) const {
@@ -1,15 +1,71 @@
 #pragma once
 
-#include "spell.hpp"
+#include "ecs.hpp"
 #include "enemies_spawner.hpp"
+#include "hitbox.hpp"
+#include "item_drops.hpp"
+#include "spell.hpp"
 #include <cstddef>
 #include <raylib.h>
+#include <vector>
+
+TAG_BY_NAME(std::size_t, spell_slot);
 
 namespace caster {
-    void clear();
-    bool cast(std::size_t spell_id, const Spell& spell, const Vector2& player_position, const Vector2& mouse_position, const Enemies& enemies);
-    void tick(const SpellBook& spellbook, Enemies& enemies, std::vector<ItemDrop>& item_drops);
+    // a beam that travels along `movement` and lingers for a bit once it stops
+    struct Beam {
+        uint16_t segment_length;
+        // in ticks, when 0 remove spell
+        uint16_t till_removal;
+        // in units, when 0 stop moving the spell
+        uint16_t till_stopped;
+        // when 0 stop creating segments
+        uint16_t create_segments;
+
+        Vector2 movement;
+
+        Beam(const spell::movement::Beam& movement_info, const Vector2& direction);
+
+        // 0, 1 points are the head
+        // 2, 3 points are the tail
+        static shapes::Polygon hitbox(const spell::movement::Beam& movement_info, const Vector2& origin,
+                                      const Vector2& mouse_position);
+
+        void advance(shapes::Polygon& hitbox);
+        // when true spell finished
+        bool count_down();
+    };
+
+    // a circle that grows to its maximal radius and then waits
+    struct Growth {
+        uint8_t until_max;
+        float radius_increase;
+        uint16_t wait;
+
+        Growth(const spell::movement::Circle& info);
+
+        void advance(shapes::Circle& hitbox);
+        // when true spell finished
+        bool count_down();
+    };
+
+    // every casted spell is an entity, `spell_slot` is the index of the spell in the spellbook
+    struct Caster {
+        using BeamArchetype = ecs::Archetype<spell_slot, Beam, shapes::Polygon>;
+        using CircleArchetype = ecs::Archetype<spell_slot, Growth, shapes::Circle>;
+
+        ecs::build<BeamArchetype, CircleArchetype> world;
+        // entities of finished spells, handed out again before asking `world` for new ones
+        std::vector<ecs::Entity> free_entities;
+
+        bool cast(std::size_t spell_id, const Spell& spell, const Vector2& player_position,
+                  const Vector2& mouse_position, const Enemies& enemies);
+        void tick(const SpellBook& spellbook, Enemies& enemies, ItemDrops& item_drops);
 #ifdef DEBUG
-    void draw_hitbox(float y);
+        void draw_hitbox(float y);
 #endif
+
+      private:
+        ecs::Entity new_entity();
+    };
 }
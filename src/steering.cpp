@@ -0,0 +1,298 @@
+#include "steering.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+#include <raymath.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STEERING_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr float half_width = ARENA_WIDTH / 2.0f;
+    constexpr float half_height = ARENA_HEIGHT / 2.0f;
+    constexpr float rad_to_deg = 180.0f / std::numbers::pi_v<float>;
+
+    // the reference everything else gets tested against, same math `EnemyPool` used to do per enemy
+    void attraction_scalar(Vector2 target, float x, float y, float& out_x, float& out_y, float& angle) {
+        Vector2 force = {target.x - x, target.y - y};
+        force.x = wrap(force.x + half_width, ARENA_WIDTH) - half_width;
+        force.y = wrap(force.y + half_height, ARENA_HEIGHT) - half_height;
+        if (Vector2LengthSqr(force) > 1e-6f) {
+            force = Vector2Normalize(force);
+        }
+
+        out_x = force.x;
+        out_y = force.y;
+        angle = std::fmod(270.0f - std::atan2(-force.y, -force.x) * rad_to_deg, 360.0f);
+    }
+
+    Vector2 push_scalar(Vector2 self, float x, float y) {
+        Vector2 d = {self.x - x, self.y - y};
+        return Vector2Scale(Vector2Normalize(d), 1.0f / std::max(Vector2Length(d), 1e-6f));
+    }
+
+    // atan(a) for a in [0, 1], off by less than 1e-5 radians
+    // a is the smaller of |x| and |y| divided by the bigger one, the rest of atan2 is just flipping quadrants
+    constexpr float atan_c0 = 0.99997726f;
+    constexpr float atan_c1 = -0.33262347f;
+    constexpr float atan_c2 = 0.19354346f;
+    constexpr float atan_c3 = -0.11643287f;
+    constexpr float atan_c4 = 0.05265332f;
+    constexpr float atan_c5 = -0.01172120f;
+
+#ifdef STEERING_X86
+    __attribute__((target("sse4.1"))) __m128 atan2_sse(__m128 y, __m128 x) {
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        __m128 ax = _mm_andnot_ps(sign, x);
+        __m128 ay = _mm_andnot_ps(sign, y);
+
+        __m128 hi = _mm_max_ps(ax, ay);
+        __m128 a = _mm_and_ps(_mm_div_ps(_mm_min_ps(ax, ay), hi), _mm_cmpgt_ps(hi, _mm_setzero_ps()));
+        __m128 s = _mm_mul_ps(a, a);
+
+        __m128 r = _mm_set1_ps(atan_c5);
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c4));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c3));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c2));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c1));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c0));
+        r = _mm_mul_ps(r, a);
+
+        r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(std::numbers::pi_v<float> / 2.0f), r), _mm_cmpgt_ps(ay, ax));
+        r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(std::numbers::pi_v<float>), r), x);
+        return _mm_xor_ps(r, _mm_and_ps(sign, y));
+    }
+
+    __attribute__((target("sse4.1"))) void attraction_sse(Vector2 target, const float* xs, const float* ys,
+                                                           float* out_x, float* out_y, float* angles, std::size_t n) {
+        const __m128 tx = _mm_set1_ps(target.x), ty = _mm_set1_ps(target.y);
+        const __m128 w = _mm_set1_ps(ARENA_WIDTH), hw = _mm_set1_ps(half_width);
+        const __m128 h = _mm_set1_ps(ARENA_HEIGHT), hh = _mm_set1_ps(half_height);
+
+        for (std::size_t i = 0; i < n; i += 4) {
+            __m128 fx = _mm_add_ps(_mm_sub_ps(tx, _mm_loadu_ps(xs + i)), hw);
+            __m128 fy = _mm_add_ps(_mm_sub_ps(ty, _mm_loadu_ps(ys + i)), hh);
+            // wrap(v, m) = v - m * floor(v / m)
+            fx = _mm_sub_ps(_mm_sub_ps(fx, _mm_mul_ps(w, _mm_floor_ps(_mm_div_ps(fx, w)))), hw);
+            fy = _mm_sub_ps(_mm_sub_ps(fy, _mm_mul_ps(h, _mm_floor_ps(_mm_div_ps(fy, h)))), hh);
+
+            __m128 len_sqr = _mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fy, fy));
+            __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len_sqr));
+            __m128 normalize = _mm_cmpgt_ps(len_sqr, _mm_set1_ps(1e-6f));
+            fx = _mm_blendv_ps(fx, _mm_mul_ps(fx, inv), normalize);
+            fy = _mm_blendv_ps(fy, _mm_mul_ps(fy, inv), normalize);
+
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            __m128 angle = _mm_sub_ps(_mm_set1_ps(270.0f),
+                                      _mm_mul_ps(atan2_sse(_mm_xor_ps(fy, sign), _mm_xor_ps(fx, sign)),
+                                                 _mm_set1_ps(rad_to_deg)));
+            // the angle is in [90, 450], so the fmod is at most one subtraction
+            __m128 over = _mm_cmpge_ps(angle, _mm_set1_ps(360.0f));
+            angle = _mm_sub_ps(angle, _mm_and_ps(over, _mm_set1_ps(360.0f)));
+
+            _mm_storeu_ps(out_x + i, fx);
+            _mm_storeu_ps(out_y + i, fy);
+            _mm_storeu_ps(angles + i, angle);
+        }
+    }
+
+    __attribute__((target("sse4.1"))) Vector2 separation_sse(Vector2 self, const float* xs, const float* ys,
+                                                             std::size_t n) {
+        const __m128 sx = _mm_set1_ps(self.x), sy = _mm_set1_ps(self.y);
+        __m128 acc_x = _mm_setzero_ps(), acc_y = _mm_setzero_ps();
+
+        for (std::size_t i = 0; i < n; i += 4) {
+            __m128 dx = _mm_sub_ps(sx, _mm_loadu_ps(xs + i));
+            __m128 dy = _mm_sub_ps(sy, _mm_loadu_ps(ys + i));
+            __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+            __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), len);
+            __m128 scale = _mm_div_ps(_mm_set1_ps(1.0f), _mm_max_ps(len, _mm_set1_ps(1e-6f)));
+            __m128 pushes = _mm_cmpgt_ps(len, _mm_setzero_ps());
+
+            acc_x = _mm_add_ps(acc_x, _mm_and_ps(pushes, _mm_mul_ps(_mm_mul_ps(dx, inv), scale)));
+            acc_y = _mm_add_ps(acc_y, _mm_and_ps(pushes, _mm_mul_ps(_mm_mul_ps(dy, inv), scale)));
+        }
+
+        // x0+x1, x2+x3, y0+y1, y2+y3
+        __m128 sums = _mm_hadd_ps(acc_x, acc_y);
+        sums = _mm_hadd_ps(sums, sums);
+        return {_mm_cvtss_f32(sums), _mm_cvtss_f32(_mm_shuffle_ps(sums, sums, 1))};
+    }
+
+    __attribute__((target("avx2"))) __m256 atan2_avx2(__m256 y, __m256 x) {
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+        __m256 ax = _mm256_andnot_ps(sign, x);
+        __m256 ay = _mm256_andnot_ps(sign, y);
+
+        __m256 hi = _mm256_max_ps(ax, ay);
+        __m256 a = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(ax, ay), hi),
+                                 _mm256_cmp_ps(hi, _mm256_setzero_ps(), _CMP_GT_OQ));
+        __m256 s = _mm256_mul_ps(a, a);
+
+        __m256 r = _mm256_set1_ps(atan_c5);
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c4));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c3));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c2));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c1));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(atan_c0));
+        r = _mm256_mul_ps(r, a);
+
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(std::numbers::pi_v<float> / 2.0f), r),
+                             _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(std::numbers::pi_v<float>), r), x);
+        return _mm256_xor_ps(r, _mm256_and_ps(sign, y));
+    }
+
+    __attribute__((target("avx2"))) void attraction_avx2(Vector2 target, const float* xs, const float* ys,
+                                                         float* out_x, float* out_y, float* angles, std::size_t n) {
+        const __m256 tx = _mm256_set1_ps(target.x), ty = _mm256_set1_ps(target.y);
+        const __m256 w = _mm256_set1_ps(ARENA_WIDTH), hw = _mm256_set1_ps(half_width);
+        const __m256 h = _mm256_set1_ps(ARENA_HEIGHT), hh = _mm256_set1_ps(half_height);
+
+        for (std::size_t i = 0; i < n; i += 8) {
+            __m256 fx = _mm256_add_ps(_mm256_sub_ps(tx, _mm256_loadu_ps(xs + i)), hw);
+            __m256 fy = _mm256_add_ps(_mm256_sub_ps(ty, _mm256_loadu_ps(ys + i)), hh);
+            fx = _mm256_sub_ps(_mm256_sub_ps(fx, _mm256_mul_ps(w, _mm256_floor_ps(_mm256_div_ps(fx, w)))), hw);
+            fy = _mm256_sub_ps(_mm256_sub_ps(fy, _mm256_mul_ps(h, _mm256_floor_ps(_mm256_div_ps(fy, h)))), hh);
+
+            __m256 len_sqr = _mm256_add_ps(_mm256_mul_ps(fx, fx), _mm256_mul_ps(fy, fy));
+            __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len_sqr));
+            __m256 normalize = _mm256_cmp_ps(len_sqr, _mm256_set1_ps(1e-6f), _CMP_GT_OQ);
+            fx = _mm256_blendv_ps(fx, _mm256_mul_ps(fx, inv), normalize);
+            fy = _mm256_blendv_ps(fy, _mm256_mul_ps(fy, inv), normalize);
+
+            const __m256 sign = _mm256_set1_ps(-0.0f);
+            __m256 angle = _mm256_sub_ps(_mm256_set1_ps(270.0f),
+                                         _mm256_mul_ps(atan2_avx2(_mm256_xor_ps(fy, sign), _mm256_xor_ps(fx, sign)),
+                                                       _mm256_set1_ps(rad_to_deg)));
+            __m256 over = _mm256_cmp_ps(angle, _mm256_set1_ps(360.0f), _CMP_GE_OQ);
+            angle = _mm256_sub_ps(angle, _mm256_and_ps(over, _mm256_set1_ps(360.0f)));
+
+            _mm256_storeu_ps(out_x + i, fx);
+            _mm256_storeu_ps(out_y + i, fy);
+            _mm256_storeu_ps(angles + i, angle);
+        }
+    }
+
+    __attribute__((target("avx2"))) Vector2 separation_avx2(Vector2 self, const float* xs, const float* ys,
+                                                            std::size_t n) {
+        const __m256 sx = _mm256_set1_ps(self.x), sy = _mm256_set1_ps(self.y);
+        __m256 acc_x = _mm256_setzero_ps(), acc_y = _mm256_setzero_ps();
+
+        for (std::size_t i = 0; i < n; i += 8) {
+            __m256 dx = _mm256_sub_ps(sx, _mm256_loadu_ps(xs + i));
+            __m256 dy = _mm256_sub_ps(sy, _mm256_loadu_ps(ys + i));
+            __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+
+            __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), len);
+            __m256 scale = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_max_ps(len, _mm256_set1_ps(1e-6f)));
+            __m256 pushes = _mm256_cmp_ps(len, _mm256_setzero_ps(), _CMP_GT_OQ);
+
+            acc_x = _mm256_add_ps(acc_x, _mm256_and_ps(pushes, _mm256_mul_ps(_mm256_mul_ps(dx, inv), scale)));
+            acc_y = _mm256_add_ps(acc_y, _mm256_and_ps(pushes, _mm256_mul_ps(_mm256_mul_ps(dy, inv), scale)));
+        }
+
+        __m128 x = _mm_add_ps(_mm256_castps256_ps128(acc_x), _mm256_extractf128_ps(acc_x, 1));
+        __m128 y = _mm_add_ps(_mm256_castps256_ps128(acc_y), _mm256_extractf128_ps(acc_y, 1));
+        __m128 sums = _mm_hadd_ps(x, y);
+        sums = _mm_hadd_ps(sums, sums);
+        return {_mm_cvtss_f32(sums), _mm_cvtss_f32(_mm_shuffle_ps(sums, sums, 1))};
+    }
+#endif
+
+    // how many of the first `n` elements the wide kernel takes care of, the rest goes through the scalar path
+    std::size_t batched(std::size_t n, steering::Isa isa) {
+        switch (isa) {
+            case steering::Isa::Scalar:
+                return 0;
+            case steering::Isa::SSE:
+                return n - n % 4;
+            case steering::Isa::AVX2:
+                return n - n % 8;
+        }
+
+        std::unreachable();
+    }
+}
+
+namespace steering {
+    Isa best() {
+        static const Isa isa = [] {
+#ifdef STEERING_X86
+            if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+            if (__builtin_cpu_supports("sse4.1")) return Isa::SSE;
+#endif
+            return Isa::Scalar;
+        }();
+
+        return isa;
+    }
+
+    bool supported(Isa isa) {
+        return static_cast<int>(isa) <= static_cast<int>(best());
+    }
+
+    void attraction(Vector2 target, std::span<const float> xs, std::span<const float> ys, std::span<float> out_x,
+                    std::span<float> out_y, std::span<float> angles, Isa isa) {
+        assert(supported(isa));
+        assert(ys.size() == xs.size() && out_x.size() == xs.size() && out_y.size() == xs.size() &&
+               angles.size() == xs.size());
+
+        std::size_t wide = batched(xs.size(), isa);
+        switch (isa) {
+            case Isa::Scalar:
+                break;
+#ifdef STEERING_X86
+            case Isa::SSE:
+                attraction_sse(target, xs.data(), ys.data(), out_x.data(), out_y.data(), angles.data(), wide);
+                break;
+            case Isa::AVX2:
+                attraction_avx2(target, xs.data(), ys.data(), out_x.data(), out_y.data(), angles.data(), wide);
+                break;
+#else
+            default:
+                std::unreachable();
+#endif
+        }
+
+        for (std::size_t i = wide; i < xs.size(); i++) {
+            attraction_scalar(target, xs[i], ys[i], out_x[i], out_y[i], angles[i]);
+        }
+    }
+
+    Vector2 separation(Vector2 self, std::span<const float> xs, std::span<const float> ys, Isa isa) {
+        assert(supported(isa));
+        assert(ys.size() == xs.size());
+
+        std::size_t wide = batched(xs.size(), isa);
+        Vector2 force = Vector2Zero();
+        switch (isa) {
+            case Isa::Scalar:
+                break;
+#ifdef STEERING_X86
+            case Isa::SSE:
+                force = separation_sse(self, xs.data(), ys.data(), wide);
+                break;
+            case Isa::AVX2:
+                force = separation_avx2(self, xs.data(), ys.data(), wide);
+                break;
+#else
+            default:
+                std::unreachable();
+#endif
+        }
+
+        for (std::size_t i = wide; i < xs.size(); i++) {
+            force += push_scalar(self, xs[i], ys[i]);
+        }
+
+        return force;
+    }
+}
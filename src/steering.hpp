@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <raylib.h>
+
+// batched steering math for enemies, positions come in as separate x and y arrays
+// every kernel has a scalar version, x86 also gets 4 wide (SSE4.1) and 8 wide (AVX2) ones picked at runtime
+namespace steering {
+    static constexpr float neighbourhood_radius = 100.0f;
+    static constexpr float weight_attraction = 3.0f;
+    static constexpr float weight_separation = 5.0f;
+
+    enum struct Isa {
+        Scalar,
+        SSE,
+        AVX2,
+    };
+
+    // the widest one this cpu can run, checked once
+    Isa best();
+    bool supported(Isa isa);
+
+    // for every `i`: normalized direction from `xs[i], ys[i]` to `target` going across the arena's edges when that's
+    // shorter, `angles[i]` is the model's facing angle in degrees
+    // all spans have to be the same size
+    void attraction(Vector2 target, std::span<const float> xs, std::span<const float> ys, std::span<float> out_x,
+                    std::span<float> out_y, std::span<float> angles, Isa isa = best());
+
+    // sum of every neighbour's push on `self`, pointing away from it and weaker the further away it is
+    // a neighbour sitting right on `self` doesn't push
+    Vector2 separation(Vector2 self, std::span<const float> xs, std::span<const float> ys, Isa isa = best());
+}
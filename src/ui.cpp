@@ -3,6 +3,7 @@
 #include "assets.hpp"
 #include "font.hpp"
 #include "hitbox.hpp"
+#include "profiler.hpp"
 #include "raylib.h"
 #include "spell.hpp"
 #include <cstdint>
@@ -93,6 +94,8 @@ namespace hud {
     }
 
     void draw(assets::Store& assets, const Player& player, const SpellBook& spellbook, const Vector2& screen) {
+        profiler::Scope zone("hud::draw");
+
         static const uint32_t padding = 10;
         static const uint32_t outer_radius = 1023 / 2;
         static const Vector2 center = (Vector2){outer_radius, outer_radius};
@@ -1,5 +1,7 @@
 #include "utility.hpp"
 
+#include "particle/particle.hpp"
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
@@ -224,8 +226,40 @@ void arena::loop_around(float& x, float& y) {
     if (y < -ARENA_HEIGHT / 2.0f) y += ARENA_HEIGHT;
 }
 
-std::mt19937 rng_gen(static_cast<unsigned long>(std::chrono::steady_clock::now().time_since_epoch().count()));
+namespace {
+    using Streams = std::array<std::mt19937, static_cast<std::size_t>(rng::Stream::Size)>;
 
-std::mt19937& rng::get() {
-    return rng_gen;
+    void seed_streams(Streams& streams, uint64_t seed) {
+        for (std::size_t i = 0; i < streams.size(); i++) {
+            std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), static_cast<uint32_t>(i)};
+            streams[i].seed(seq);
+        }
+    }
+
+    uint64_t rng_seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    Streams rng_streams = [] {
+        Streams streams;
+        seed_streams(streams, rng_seed);
+        return streams;
+    }();
+}
+
+void rng::seed(uint64_t seed) {
+    rng_seed = seed;
+    seed_streams(rng_streams, seed);
+    particle_system::seed(seed);
+}
+
+uint64_t rng::seed() {
+    return rng_seed;
+}
+
+std::mt19937& rng::get(Stream stream) {
+    return rng_streams[static_cast<std::size_t>(stream)];
+}
+
+int rng::value(Stream stream, int min, int max) {
+    if (min > max) std::swap(min, max);
+
+    return std::uniform_int_distribution<int>(min, max)(get(stream));
 }
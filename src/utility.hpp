@@ -1,6 +1,7 @@
 #pragma once
 
 #include "hitbox.hpp"
+#include <cstdint>
 #include <random>
 #include <span>
 #include <string_view>
@@ -80,6 +81,26 @@ namespace arena {
     void loop_around(float& x, float& y);
 }
 
+// every part of the game draws from its own stream, so an extra draw in one of them doesn't shift what all the others
+// get, and the same seed always plays out the same way
 namespace rng {
-    std::mt19937& get();
+    enum struct Stream : uint8_t {
+        // stats of new enemies and their steering jitter
+        Enemies,
+        // what spawns and where
+        Spawner,
+        // whether killed enemies drop something
+        Drops,
+        Spells,
+        PowerUps,
+        Size,
+    };
+
+    // seeds every stream and the particle systems, they start out seeded from the clock
+    void seed(uint64_t seed);
+    uint64_t seed();
+
+    std::mt19937& get(Stream stream);
+    // same as raylib's `GetRandomValue`, both ends included
+    int value(Stream stream, int min, int max);
 };
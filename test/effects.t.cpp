@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "jobs.hpp"
+#include "particle/effects.hpp"
+#include <vector>
+
+namespace {
+    std::vector<particle_system::System> explosions(std::size_t n) {
+        std::vector<particle_system::System> systems;
+        for (std::size_t i = 0; i < n; i++) {
+            auto& system = systems.emplace_back(effect::Plosion{
+                .type = effect::Plosion::Ex,
+                .radius = 10.0f,
+                .particle_count = 1000,
+                .emit_rate = 20000.0f,
+                .color = {{RED, 0.0f}, {YELLOW, 30.0f}},
+            }({static_cast<float>(i) * 10.0f, 0.0f}));
+            system.rng.seed(static_cast<unsigned int>(i));
+        }
+        return systems;
+    }
+}
+
+TEST_CASE("Systems end up the same no matter which thread updates them", "[effects]") {
+    auto workers = GENERATE(1uz, 3uz);
+    constexpr std::size_t count = 8;
+
+    auto serial = explosions(count);
+    auto parallel = explosions(count);
+
+    jobs::Pool pool(workers);
+    for (int tick = 0; tick < 30; tick++) {
+        for (auto& system : serial) {
+            system.update(1.0f / 60.0f);
+        }
+        pool.parallel_for(count, 1, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; i++) {
+                parallel[i].update(1.0f / 60.0f);
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        INFO("system " << i);
+        auto& a = serial[i].particles;
+        auto& b = parallel[i].particles;
+
+        REQUIRE(a.alive_count == b.alive_count);
+        for (std::size_t j = 0; j < a.alive_count; j++) {
+            REQUIRE(a.pos[j].x == b.pos[j].x);
+            REQUIRE(a.pos[j].y == b.pos[j].y);
+            REQUIRE(a.pos[j].z == b.pos[j].z);
+            REQUIRE(a.lifetime[j] == b.lifetime[j]);
+        }
+    }
+}
@@ -15,13 +15,11 @@ TEST_CASE("Spawn every second", "[enemy][raylib]") {
     std::size_t n = 32;
     Enemies enemies(100);
 
-    EnemyModels enemy_models{};
-
     for (std::size_t i = 0; i < TICKS * n; i++) {
-        enemies.tick(shapes::Circle(Vector2Zero(), 1.0f), enemy_models);
+        enemies.tick(shapes::Circle(Vector2Zero(), 1.0f));
     }
 
-    REQUIRE(enemies.enemies.data->size() == n);
+    REQUIRE(enemies.enemies.size() == n);
 
     CloseWindow();
 }
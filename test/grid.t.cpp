@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "grid.hpp"
+#include "quadtree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using Grid = grid::Grid<quadtree::pos<uint32_t>>;
+
+static_assert(grid::Broadphase<Grid, quadtree::pos<uint32_t>>);
+static_assert(grid::Broadphase<quadtree::QuadTree<4, quadtree::pos<uint32_t>>, quadtree::pos<uint32_t>>);
+
+namespace {
+    const quadtree::Box world({-100.0f, -100.0f}, {100.0f, 100.0f});
+
+    void fill(Grid& g, std::mt19937& gen, std::size_t n) {
+        std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+
+        for (uint32_t i = 0; i < n; i++) {
+            g.insert(Vector2{coord(gen), coord(gen)}, uint32_t(i));
+        }
+    }
+
+    void check_query(Grid& g, const quadtree::Box& box) {
+        std::vector<uint32_t> found;
+        g.in_box(box, [&](const auto& p, auto) { found.emplace_back(*p); });
+
+        std::vector<uint32_t> expected;
+        for (const auto& p : *g.data) {
+            if (box.contains(p.position())) expected.emplace_back(*p);
+        }
+
+        std::ranges::sort(found);
+        std::ranges::sort(expected);
+        REQUIRE(found == expected);
+    }
+
+    void check_queries(Grid& g, std::mt19937& gen) {
+        std::uniform_real_distribution<float> coord(-110.0f, 100.0f);
+        for (int i = 0; i < 20; i++) {
+            float x = coord(gen);
+            float y = coord(gen);
+            check_query(g, quadtree::Box({x, y}, {x + 25.0f, y + 25.0f}));
+        }
+    }
+}
+
+TEST_CASE("Grid updates", "[grid]") {
+    std::mt19937 gen(1);
+    Grid g(world, true, 10.0f);
+    fill(g, gen, 500);
+
+    std::uniform_real_distribution<float> step(-15.0f, 15.0f);
+    for (int tick = 0; tick < 20; tick++) {
+        for (std::size_t i = 0; i < g.data->size(); i += 2) {
+            auto pos = g.data.vec[i].position();
+            pos.x += step(gen);
+            pos.y += step(gen);
+            world.wrap_around(pos);
+            g.data.vec[i].set_position(pos);
+            g.update(i);
+        }
+
+        // queries have to be right before `maintain` too, moved entries are only in the overflow
+        check_queries(g, gen);
+        g.maintain();
+        check_queries(g, gen);
+    }
+}
+
+TEST_CASE("Grid removal while querying", "[grid]") {
+    std::mt19937 gen(2);
+    Grid g(world, false, 10.0f);
+    fill(g, gen, 300);
+    g.maintain();
+    fill(g, gen, 50);
+
+    std::size_t visited = 0;
+    g.query(quadtree::Box({-50.0f, -50.0f}, {50.0f, 50.0f}), [](const auto&) { return true; },
+            [&](auto&, std::size_t ix) {
+                visited++;
+                g.remove(ix);
+            });
+
+    REQUIRE(visited + g.data->size() == 350);
+    check_queries(g, gen);
+    for (const auto& p : *g.data) {
+        REQUIRE(!quadtree::Box({-50.0f, -50.0f}, {50.0f, 50.0f}).contains(p.position()));
+    }
+
+    g.maintain();
+    check_queries(g, gen);
+}
+
+TEST_CASE("Grid nearest neighbours", "[grid]") {
+    bool toroidal = GENERATE(false, true);
+    std::mt19937 gen(3);
+    Grid g(world, toroidal, 10.0f);
+    fill(g, gen, 200);
+    g.maintain();
+    fill(g, gen, 20);
+
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    for (int i = 0; i < 50; i++) {
+        Vector2 point = {coord(gen), coord(gen)};
+
+        std::vector<float> expected;
+        for (const auto& p : *g.data) {
+            expected.emplace_back(g.distance_sqr(p.position(), point));
+        }
+        std::ranges::sort(expected);
+
+        auto nearest = g.k_nearest(point, 5);
+        REQUIRE(nearest.size() == 5);
+        for (std::size_t k = 0; k < nearest.size(); k++) {
+            REQUIRE(g.distance_sqr(g.data.vec[nearest[k]].position(), point) == expected[k]);
+        }
+    }
+
+    // sparse enough that the rings give up and look at everything
+    Grid sparse(world, toroidal, 10.0f);
+    sparse.insert(Vector2{-95.0f, -95.0f}, uint32_t(0));
+    sparse.insert(Vector2{95.0f, 95.0f}, uint32_t(1));
+    sparse.maintain();
+    REQUIRE(*sparse.data.vec[*sparse.closest_to({90.0f, 90.0f})] == 1);
+    REQUIRE(sparse.k_nearest({0.0f, 0.0f}, 10).size() == 2);
+}
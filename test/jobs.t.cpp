@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "jobs.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("parallel_for visits every index once", "[jobs]") {
+    auto workers = GENERATE(0uz, 1uz, 3uz, 8uz);
+    auto n = GENERATE(0uz, 1uz, 63uz, 64uz, 1000uz);
+    auto grain = GENERATE(1uz, 16uz, 100uz);
+
+    jobs::Pool pool(workers);
+    REQUIRE(pool.thread_count() == workers + 1);
+
+    // catch's assertions aren't thread safe, everything gets checked after
+    std::vector<std::atomic<int>> visits(n);
+    std::atomic<bool> too_big = false;
+    pool.parallel_for(n, grain, [&](std::size_t begin, std::size_t end) {
+        if (end - begin > grain) too_big = true;
+        for (auto i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+
+    REQUIRE(!too_big);
+    for (std::size_t i = 0; i < n; i++) {
+        REQUIRE(visits[i] == 1);
+    }
+}
+
+TEST_CASE("parallel_for can be nested", "[jobs]") {
+    jobs::Pool pool(4);
+
+    std::atomic<std::size_t> sum = 0;
+    pool.parallel_for(16, 1, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; i++) {
+            pool.parallel_for(100, 10, [&](std::size_t b, std::size_t e) {
+                for (auto j = b; j < e; j++) {
+                    sum += j;
+                }
+            });
+        }
+    });
+
+    REQUIRE(sum == 16 * (99 * 100 / 2));
+}
+
+TEST_CASE("parallel_for runs on the workers", "[jobs]") {
+    jobs::Pool pool(3);
+
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    // enough rounds that every worker wakes up for at least one of them
+    for (int round = 0; round < 100 && ids.size() < 2; round++) {
+        pool.parallel_for(64, 1, [&](std::size_t, std::size_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+            std::lock_guard lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        });
+    }
+
+    REQUIRE(ids.size() >= 2);
+}
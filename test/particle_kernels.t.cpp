@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "particle/kernels.hpp"
+#include "particle/particle.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace particle_system;
+
+namespace {
+    std::vector<float> random_floats(std::mt19937& gen, std::size_t n, float spread) {
+        std::uniform_real_distribution<float> value(-spread, spread);
+
+        std::vector<float> v(n);
+        for (auto& f : v) {
+            f = value(gen);
+        }
+        return v;
+    }
+
+    std::vector<Color> random_colors(std::mt19937& gen, std::size_t n) {
+        std::uniform_int_distribution<int> channel(0, 255);
+
+        std::vector<Color> v(n);
+        for (auto& c : v) {
+            c = Color{static_cast<unsigned char>(channel(gen)), static_cast<unsigned char>(channel(gen)),
+                      static_cast<unsigned char>(channel(gen)), static_cast<unsigned char>(channel(gen))};
+        }
+        return v;
+    }
+
+    bool same(Color a, Color b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+}
+
+TEST_CASE("Particle kernels match scalar", "[particle]") {
+    auto isa = GENERATE(kernels::Isa::AVX2);
+    // nothing to compare on a cpu without it
+    if (!kernels::supported(isa)) return;
+
+    std::mt19937 gen(42);
+    // odd sizes so the scalar tail runs too
+    auto n = GENERATE(1uz, 7uz, 64uz, 1003uz);
+
+    SECTION("integrate") {
+        auto pos = random_floats(gen, 3 * n, 500.0f);
+        auto velocity = random_floats(gen, 3 * n, 50.0f);
+        auto acceleration = random_floats(gen, 3 * n, 5.0f);
+
+        auto expected_pos = pos;
+        auto expected_velocity = velocity;
+        kernels::integrate(expected_pos, expected_velocity, acceleration, 1.0f / 60.0f, kernels::Isa::Scalar);
+        kernels::integrate(pos, velocity, acceleration, 1.0f / 60.0f, isa);
+
+        // same operations in the same order, so not even rounding differs
+        REQUIRE(pos == expected_pos);
+        REQUIRE(velocity == expected_velocity);
+    }
+
+    SECTION("decay") {
+        auto lifetime = random_floats(gen, n, 3.0f);
+
+        auto expected = lifetime;
+        kernels::decay(expected, 1.0f / 60.0f, kernels::Isa::Scalar);
+        kernels::decay(lifetime, 1.0f / 60.0f, isa);
+
+        REQUIRE(lifetime == expected);
+    }
+
+    SECTION("color by velocity") {
+        auto speeds = random_floats(gen, 3 * n, 10.0f);
+        std::vector<Vector3> velocity(n);
+        std::memcpy(velocity.data(), speeds.data(), sizeof(Vector3) * n);
+        // both ends of the ramp, the fade below it and past the top of it
+        if (n > 3) {
+            velocity[0] = Vector3Zero();
+            velocity[1] = {1.0f, 0.0f, 0.0f};
+            velocity[2] = {0.0f, 0.0f, 4.0f};
+            velocity[3] = {0.0f, 20.0f, 0.0f};
+        }
+        auto color = random_colors(gen, n);
+
+        auto expected = color;
+        kernels::color_by_velocity(velocity, expected, RED, YELLOW, 1.0f, 4.0f, kernels::Isa::Scalar);
+        kernels::color_by_velocity(velocity, color, RED, YELLOW, 1.0f, 4.0f, isa);
+
+        for (std::size_t i = 0; i < n; i++) {
+            INFO("i = " << i);
+            REQUIRE(same(color[i], expected[i]));
+        }
+    }
+}
+
+TEST_CASE("Lifetime updater keeps the survivors in order", "[particle]") {
+    Particles particles(16);
+    for (std::size_t i = 0; i < 10; i++) {
+        particles.pos[i] = {static_cast<float>(i), 0.0f, 0.0f};
+        // every third one runs out this update
+        particles.lifetime[i] = i % 3 == 0 ? 0.5f : 2.0f;
+        particles.wake(i);
+    }
+
+    updaters::Lifetime().update(particles, 1.0f);
+
+    std::vector<float> expected = {1.0f, 2.0f, 4.0f, 5.0f, 7.0f, 8.0f};
+    REQUIRE(particles.alive_count == expected.size());
+    for (std::size_t i = 0; i < particles.max_size; i++) {
+        INFO("i = " << i);
+        REQUIRE(particles.alive[i] == (i < expected.size()));
+        if (i < expected.size()) {
+            REQUIRE(particles.pos[i].x == expected[i]);
+            REQUIRE(particles.lifetime[i] == 1.0f);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "particle/particle.hpp"
+#include "particle/pipeline.hpp"
+#include <random>
+
+using namespace particle_system;
+
+namespace {
+    void scale_size(Particles& particles, float, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            particles.size[i] = 0.5f * Vector3Length(particles.velocity[i]);
+        }
+    }
+
+    void fill(Particles& particles, std::size_t n) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> lifetime(0.0f, 2.0f);
+
+        for (std::size_t i = 0; i < n; i++) {
+            particles.pos[i] = {value(gen), value(gen), value(gen)};
+            particles.velocity[i] = {value(gen), value(gen), value(gen)};
+            particles.acceleration[i] = {value(gen), value(gen), value(gen)};
+            particles.color[i] = BLUE;
+            particles.lifetime[i] = lifetime(gen);
+            particles.wake(i);
+        }
+    }
+
+    // exactly, not within raymath's epsilon
+    bool same(Vector3 a, Vector3 b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    bool same(Color a, Color b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    bool same(const Particles& a, const Particles& b) {
+        if (a.alive_count != b.alive_count) return false;
+
+        for (std::size_t i = 0; i < a.alive_count; i++) {
+            if (!same(a.pos[i], b.pos[i]) || !same(a.velocity[i], b.velocity[i]) || !same(a.color[i], b.color[i]) ||
+                a.lifetime[i] != b.lifetime[i] || a.size[i] != b.size[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Updater pipeline matches the updaters one by one", "[particle]") {
+    // more than one chunk, with the last one cut short
+    auto n = GENERATE(1uz, 100uz, pipeline::chunk_size, 3 * pipeline::chunk_size + 17);
+
+    Particles separate(n + 1), fused(n + 1);
+    fill(separate, n);
+    fill(fused, n);
+
+    updaters::Position position;
+    updaters::Lifetime lifetime;
+    updaters::ColorByVelocity color(RED, YELLOW, 5.0f, 15.0f);
+    pipeline::Updaters pipeline(updaters::Position(), updaters::Lifetime(),
+                                updaters::ColorByVelocity(RED, YELLOW, 5.0f, 15.0f), scale_size);
+
+    for (int tick = 0; tick < 10; tick++) {
+        position.update(separate, 0.1f);
+        lifetime.update(separate, 0.1f);
+        color.update(separate, 0.1f);
+        scale_size(separate, 0.1f, 0, separate.alive_count);
+
+        pipeline(fused, 0.1f);
+
+        REQUIRE(same(separate, fused));
+    }
+    // some of them had to die on the way
+    REQUIRE(fused.alive_count < n + (n == 1));
+}
+
+TEST_CASE("Generator pipeline matches the generators one by one", "[particle]") {
+    // within one chunk both take the same numbers out of the rng in the same order
+    constexpr std::size_t n = pipeline::chunk_size / 2;
+
+    auto make = [](bool fused) {
+        System system(n + 1, renderers::Point(n + 1));
+        emitters::CustomEmitter emitter(1e6f, n);
+
+        auto pos = generators::pos::OnSphere(Vector3Zero(), {1.0f, 2.0f});
+        auto velocity = generators::velocity::Sphere(5.0f);
+        auto scale = generators::velocity::ScaleRange(1.0f, 3.0f);
+        auto lifetime = generators::lifetime::Range(1.0f, 2.0f);
+        if (fused) {
+            emitter.add_generator(pipeline::Generators(pos, velocity, scale, lifetime));
+        } else {
+            emitter.add_generator(pos);
+            emitter.add_generator(velocity);
+            emitter.add_generator(scale);
+            emitter.add_generator(lifetime);
+        }
+        system.add_emitter(std::move(emitter));
+        system.rng.seed(7);
+
+        return system;
+    };
+
+    auto separate = make(false);
+    auto fused = make(true);
+    separate.update(1.0f);
+    fused.update(1.0f);
+
+    REQUIRE(fused.particles.alive_count == n);
+    REQUIRE(same(separate.particles, fused.particles));
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "profiler.hpp"
+#include <sstream>
+#include <string>
+
+TEST_CASE("Profiler records nothing while disabled", "[profiler]") {
+    profiler::clear();
+    profiler::enable(false);
+
+    profiler::begin_frame();
+    {
+        profiler::Scope zone("outer");
+    }
+    profiler::end_frame();
+
+    REQUIRE(profiler::frame_count() == 0);
+}
+
+TEST_CASE("Profiler zones nest inside their frame", "[profiler]") {
+    profiler::clear();
+    profiler::enable(true);
+
+    // outside of a frame, dropped
+    {
+        profiler::Scope zone("early");
+    }
+
+    profiler::begin_frame();
+    {
+        profiler::Scope outer("outer");
+        {
+            profiler::Scope inner("inner");
+        }
+    }
+    profiler::end_frame();
+
+    REQUIRE(profiler::frame_count() == 1);
+    const auto& frame = profiler::frame(0);
+    REQUIRE(frame.zones.size() == 2);
+
+    // zones are kept in the order they ended
+    const auto& inner = frame.zones[0];
+    const auto& outer = frame.zones[1];
+    REQUIRE(std::string(inner.name) == "inner");
+    REQUIRE(std::string(outer.name) == "outer");
+    REQUIRE(inner.depth == 1);
+    REQUIRE(outer.depth == 0);
+    REQUIRE(inner.thread == frame.thread);
+
+    REQUIRE(frame.start <= outer.start);
+    REQUIRE(outer.start <= inner.start);
+    REQUIRE(inner.end <= outer.end);
+    REQUIRE(outer.end <= frame.end);
+
+    profiler::enable(false);
+    profiler::clear();
+}
+
+TEST_CASE("Profiler history keeps the newest frames", "[profiler]") {
+    profiler::clear();
+    profiler::enable(true);
+
+    for (std::size_t i = 0; i < profiler::history_size + 10; i++) {
+        profiler::begin_frame();
+        profiler::end_frame();
+    }
+
+    REQUIRE(profiler::frame_count() == profiler::history_size);
+    for (std::size_t i = 1; i < profiler::frame_count(); i++) {
+        REQUIRE(profiler::frame(i).index == profiler::frame(i - 1).index + 1);
+    }
+    REQUIRE(profiler::frame(profiler::frame_count() - 1).index - profiler::frame(0).index ==
+            profiler::history_size - 1);
+
+    profiler::enable(false);
+    profiler::clear();
+}
+
+TEST_CASE("Profiler exports chrome traces", "[profiler]") {
+    profiler::clear();
+    profiler::enable(true);
+
+    profiler::begin_frame();
+    {
+        profiler::Scope zone("Enemies::tick");
+    }
+    profiler::end_frame();
+
+    std::stringstream out;
+    profiler::export_chrome_trace(out);
+    auto trace = out.str();
+
+    REQUIRE(trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    REQUIRE(trace.ends_with("]}\n"));
+    REQUIRE(trace.find("\"name\":\"frame\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"Enemies::tick\",\"ph\":\"X\"") != std::string::npos);
+
+    profiler::enable(false);
+    profiler::clear();
+}
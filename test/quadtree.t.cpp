@@ -0,0 +1,222 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "quadtree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using QT = quadtree::QuadTree<4, quadtree::pos<uint32_t>>;
+
+namespace {
+    const quadtree::Box world({-100.0f, -100.0f}, {100.0f, 100.0f});
+
+    void fill(QT& qt, std::mt19937& gen, std::size_t n) {
+        std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+
+        for (uint32_t i = 0; i < n; i++) {
+            qt.insert(Vector2{coord(gen), coord(gen)}, uint32_t(i));
+        }
+    }
+
+    void move(QT& qt, std::mt19937& gen, std::size_t ix) {
+        std::uniform_real_distribution<float> step(-15.0f, 15.0f);
+
+        auto& p = qt.data.vec[ix];
+        Vector2 pos = {p.position().x + step(gen), p.position().y + step(gen)};
+        world.wrap_around(pos);
+        p.set_position(pos);
+    }
+
+    // every entry has to live in exactly one leaf, the one recorded for it, and that leaf has to contain it
+    void check_leaves(QT& qt) {
+        std::size_t live_entries = 0;
+        for (const auto& node : *qt.nodes) {
+            live_entries += static_cast<std::size_t>(std::ranges::count_if(node.data, [&](const auto& dat) {
+                return qt.data.contains(dat);
+            }));
+        }
+        REQUIRE(live_entries == qt.data->size());
+
+        for (std::size_t i = 0; i < qt.data->size(); i++) {
+            REQUIRE(qt.nodes.contains(qt.leaves[i]));
+
+            const auto& leaf = qt.nodes[qt.leaves[i]];
+            REQUIRE(!leaf.subdivided);
+            REQUIRE(leaf.bbox.contains(qt.data.vec[i].position()));
+            REQUIRE(std::ranges::find(leaf.data, qt.data.handle_of(i)) != leaf.data.end());
+        }
+    }
+
+    void check_query(QT& qt, const quadtree::Box& box) {
+        std::vector<uint32_t> found;
+        qt.in_box(box, [&](const auto& p, auto) { found.emplace_back(*p); });
+
+        std::vector<uint32_t> expected;
+        for (const auto& p : *qt.data) {
+            if (box.contains(p.position())) expected.emplace_back(*p);
+        }
+
+        std::ranges::sort(found);
+        std::ranges::sort(expected);
+        REQUIRE(found == expected);
+    }
+}
+
+TEST_CASE("Incremental updates", "[quadtree]") {
+    std::mt19937 gen(1);
+    QT qt(world);
+    fill(qt, gen, 500);
+
+    for (int tick = 0; tick < 50; tick++) {
+        for (std::size_t i = 0; i < qt.data->size(); i += 3) {
+            move(qt, gen, i);
+            qt.update(i);
+        }
+        qt.maintain();
+
+        check_leaves(qt);
+    }
+
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    for (int i = 0; i < 20; i++) {
+        float x = coord(gen);
+        float y = coord(gen);
+        check_query(qt, quadtree::Box({x, y}, {x + 30.0f, y + 30.0f}));
+    }
+}
+
+TEST_CASE("Unmoved entries stay put", "[quadtree]") {
+    std::mt19937 gen(2);
+    QT qt(world);
+    fill(qt, gen, 100);
+
+    auto node_count = qt.nodes->size();
+    for (std::size_t i = 0; i < qt.data->size(); i++) {
+        REQUIRE(!qt.update(i));
+    }
+    REQUIRE(qt.nodes->size() == node_count);
+    REQUIRE(qt.stale == 0);
+}
+
+TEST_CASE("Removal prunes the tree", "[quadtree]") {
+    std::mt19937 gen(3);
+    QT qt(world);
+    fill(qt, gen, 500);
+
+    auto node_count = qt.nodes->size();
+    while (qt.data->size() > 3) {
+        qt.remove(qt.data->size() / 2);
+        qt.maintain();
+    }
+    qt.prune();
+
+    REQUIRE(qt.nodes->size() < node_count);
+    REQUIRE(qt.nodes->size() == 1);
+    check_leaves(qt);
+    check_query(qt, world);
+}
+
+TEST_CASE("Stale handles", "[quadtree]") {
+    std::mt19937 gen(4);
+    QT qt(world);
+    fill(qt, gen, 50);
+
+    auto first = qt.data.handle_of(0);
+    auto last = qt.data.handle_of(qt.data->size() - 1);
+    auto last_value = *qt.data[last];
+
+    qt.remove(first);
+    REQUIRE(!qt.data.contains(first));
+    REQUIRE(!qt.data.lookup(first));
+    // the last entry got swapped into the hole, its handle still has to find it
+    REQUIRE(qt.data.lookup(last) == 0);
+    REQUIRE(*qt.data[last] == last_value);
+
+    // reused slots don't resurrect old handles
+    auto reused = qt.insert(Vector2{0.0f, 0.0f}, uint32_t(1000));
+    REQUIRE(reused.index == first.index);
+    REQUIRE(!qt.data.contains(first));
+    REQUIRE(qt.data.contains(reused));
+    check_leaves(qt);
+}
+
+TEST_CASE("Stacked entries stop subdividing", "[quadtree]") {
+    QT qt(world);
+
+    for (uint32_t i = 0; i < 50; i++) {
+        qt.insert(Vector2{10.0f, 10.0f}, uint32_t(i));
+    }
+
+    for (const auto& node : *qt.nodes) {
+        REQUIRE(node.depth <= QT::max_depth);
+    }
+    check_leaves(qt);
+    check_query(qt, quadtree::Box({0.0f, 0.0f}, {20.0f, 20.0f}));
+}
+
+TEST_CASE("Nearest neighbours", "[quadtree]") {
+    bool toroidal = GENERATE(false, true);
+    std::mt19937 gen(5);
+    QT qt(world, toroidal);
+    fill(qt, gen, 300);
+
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    for (int i = 0; i < 50; i++) {
+        Vector2 point = {coord(gen), coord(gen)};
+
+        std::vector<std::pair<float, std::size_t>> expected;
+        for (std::size_t ix = 0; ix < qt.data->size(); ix++) {
+            auto d = Vector2Subtract(qt.data.vec[ix].position(), point);
+            if (toroidal) {
+                d.x = std::min(std::abs(d.x), 200.0f - std::abs(d.x));
+                d.y = std::min(std::abs(d.y), 200.0f - std::abs(d.y));
+            }
+            expected.emplace_back(d.x * d.x + d.y * d.y, ix);
+        }
+        std::ranges::sort(expected);
+
+        auto nearest = qt.k_nearest(point, 7);
+        REQUIRE(nearest.size() == 7);
+        for (std::size_t k = 0; k < nearest.size(); k++) {
+            REQUIRE(qt.distance_sqr(qt.data.vec[nearest[k]].position(), point) == expected[k].first);
+        }
+
+        REQUIRE(qt.closest_to(point) == nearest.front());
+    }
+
+    REQUIRE(qt.k_nearest({0.0f, 0.0f}, 1000).size() == qt.data->size());
+}
+
+TEST_CASE("Wrapped queries", "[quadtree]") {
+    std::size_t images = 0;
+    auto count = [&images](const Vector2&) { images++; };
+
+    quadtree::for_each_image(world, quadtree::Box({-10.0f, -10.0f}, {10.0f, 10.0f}), count);
+    REQUIRE(images == 1);
+
+    images = 0;
+    quadtree::for_each_image(world, quadtree::Box({90.0f, -10.0f}, {110.0f, 10.0f}), count);
+    REQUIRE(images == 2);
+
+    images = 0;
+    quadtree::for_each_image(world, quadtree::Box({90.0f, 90.0f}, {110.0f, 110.0f}), count);
+    REQUIRE(images == 4);
+
+    QT qt(world, true);
+    qt.insert(Vector2{-98.0f, -98.0f}, uint32_t(0));
+    qt.insert(Vector2{98.0f, -98.0f}, uint32_t(1));
+    qt.insert(Vector2{0.0f, 0.0f}, uint32_t(2));
+
+    // a box over the top right corner reaches the other three corners through the wrap
+    quadtree::Box query({90.0f, 90.0f}, {110.0f, 110.0f});
+    std::vector<uint32_t> found;
+    qt.for_each_image(query, [&](const Vector2& shift) {
+        quadtree::Box image(Vector2Add(query.min, shift), Vector2Add(query.max, shift));
+        qt.in_box(image, [&](const auto& p, auto) { found.emplace_back(*p); });
+    });
+
+    std::ranges::sort(found);
+    REQUIRE(found == std::vector<uint32_t>{0, 1});
+}
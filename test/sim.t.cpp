@@ -0,0 +1,177 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "particle/effects.hpp"
+#include "sim.hpp"
+#include "utility.hpp"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+
+TEST_CASE("Headless world ticks without a window", "[sim]") {
+    {
+        sim::World world(50);
+        auto speed = static_cast<float>(world.player.stats.speed.get());
+
+        for (int i = 0; i < 5 * TICKS; i++) {
+            world.player.health = world.player.stats.max_health.get();
+            world.tick(sim::Input{.movement = {1.0f, 0.0f}});
+        }
+
+        REQUIRE(world.ticks == 5 * TICKS);
+        REQUIRE(world.player.total_position.x == 5 * TICKS * speed);
+        REQUIRE(world.player.total_position.y == 0.0f);
+        // one spawn every second
+        REQUIRE(world.enemies.enemies.size() > 0);
+    }
+
+    effects::clean();
+}
+
+TEST_CASE("Headless world casts the equipped spell", "[sim]") {
+    {
+        sim::World world;
+        const auto& spell = world.save.get_spellbook()[0];
+        auto mana = world.player.mana;
+
+        world.cast(0, {100.0f, 0.0f});
+        REQUIRE(world.player.mana == mana - spell.stats.manacost.get());
+        REQUIRE(spell.current_cooldown == spell.cooldown);
+
+        // still cooling down
+        world.cast(0, {100.0f, 0.0f});
+        REQUIRE(world.player.mana == mana - spell.stats.manacost.get());
+
+        // nothing equipped there
+        world.cast(1, {100.0f, 0.0f});
+        REQUIRE(world.player.mana == mana - spell.stats.manacost.get());
+    }
+
+    effects::clean();
+}
+
+namespace {
+    // walks in a circle and casts whenever it can, levels up and equips the same way `manalter_sim` does
+    void play(sim::World& world, uint64_t ticks) {
+        for (uint64_t i = 0; i < ticks; i++) {
+            auto angle = static_cast<float>(i / TICKS) * PI / 4.0f;
+            Vector2 movement = {std::cos(angle), std::sin(angle)};
+
+            world.cast(0, xz_component(world.player.position) + movement * 100.0f);
+            auto outcome = world.tick(sim::Input{.movement = movement, .angle = angle * RAD2DEG});
+            if (outcome.leveled_up) world.level_up(1);
+            if (world.player.unlocked_spell_count > 1 && world.save.get_spellbook().size() > 1 &&
+                world.player.get_equipped_spell(1) == std::numeric_limits<uint64_t>::max()) {
+                world.equip(1, 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Same seed plays out the same way", "[sim]") {
+    {
+        sim::World first(100, 42);
+        first.god = true;
+        first.record();
+        play(first, 20 * TICKS);
+        effects::clean();
+
+        sim::World second(100, 42);
+        second.god = true;
+        play(second, 20 * TICKS);
+        effects::clean();
+
+        REQUIRE(first.checksum() == second.checksum());
+        REQUIRE(first.recording->frames.size() == 20 * TICKS);
+        REQUIRE(first.recording->frames.back().checksum == first.checksum());
+
+        REQUIRE(sim::replay(*first.recording) == std::nullopt);
+        effects::clean();
+
+        // a different input somewhere in the middle has to show up right there
+        auto tampered = *first.recording;
+        tampered.frames[5 * TICKS].input.movement = {0.0f, 0.0f};
+        REQUIRE(sim::replay(tampered) == 5 * TICKS);
+    }
+
+    effects::clean();
+}
+
+TEST_CASE("Recordings survive serialization", "[sim]") {
+    {
+        sim::World world(100, 7);
+        world.god = true;
+        world.record();
+        play(world, 5 * TICKS);
+
+        std::stringstream stream;
+        world.recording->serialize(stream);
+
+        auto read = sim::Recording::deserialize(stream);
+        REQUIRE(read.has_value());
+        REQUIRE(read->seed == 7);
+        REQUIRE(read->max_enemies == 100);
+        REQUIRE(read->god);
+        REQUIRE(read->frames.size() == world.recording->frames.size());
+        for (std::size_t i = 0; i < read->frames.size(); i++) {
+            const auto& a = read->frames[i];
+            const auto& b = world.recording->frames[i];
+            REQUIRE(a.events.size() == b.events.size());
+            REQUIRE(a.input.movement.x == b.input.movement.x);
+            REQUIRE(a.input.movement.y == b.input.movement.y);
+            REQUIRE(a.input.angle == b.input.angle);
+            REQUIRE(a.checksum == b.checksum);
+        }
+
+        // cut off halfway
+        auto bytes = stream.str();
+        std::stringstream cut(bytes.substr(0, bytes.size() / 2));
+        REQUIRE(!sim::Recording::deserialize(cut).has_value());
+    }
+
+    effects::clean();
+}
+
+TEST_CASE("Scenarios load up the arena", "[sim]") {
+    {
+        sim::World world(100, 11);
+        world.god = true;
+        world.populate(sim::Scenario{.enemies = 2000, .spells = 20, .item_drops = 300});
+
+        REQUIRE(world.enemies.enemies.size() == 2000);
+        REQUIRE(world.enemies.max_cap >= 2000);
+        REQUIRE(world.enemies.cap_limit >= world.enemies.max_cap);
+        REQUIRE(world.storm.size() == 20);
+        REQUIRE(world.save.get_spellbook().size() == 1 + 20);
+        REQUIRE(world.lying_item_drops() == 300);
+        REQUIRE(world.active_spells() == 0);
+
+        world.tick(sim::Input{});
+        // every one of them was ready
+        REQUIRE(world.active_spells() > 0);
+    }
+
+    effects::clean();
+}
+
+TEST_CASE("Scenario recordings replay", "[sim]") {
+    {
+        sim::World world(100, 13);
+        world.god = true;
+        world.populate(sim::Scenario{.enemies = 500, .spells = 5, .item_drops = 50});
+        world.record();
+        play(world, 3 * TICKS);
+
+        std::stringstream stream;
+        world.recording->serialize(stream);
+
+        auto read = sim::Recording::deserialize(stream);
+        REQUIRE(read.has_value());
+        REQUIRE(read->scenario.enemies == 500);
+        REQUIRE(read->scenario.spells == 5);
+        REQUIRE(read->scenario.item_drops == 50);
+        REQUIRE(!sim::replay(*read).has_value());
+    }
+
+    effects::clean();
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "raymath.h"
+#include "steering.hpp"
+#include "utility.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+    // degrees, the batched kernels approximate atan2
+    constexpr float angle_tolerance = 1e-3f;
+
+    struct Positions {
+        std::vector<float> xs;
+        std::vector<float> ys;
+    };
+
+    Positions random_positions(std::mt19937& gen, std::size_t n, Vector2 center, float spread) {
+        std::uniform_real_distribution<float> offset(-spread, spread);
+
+        Positions p;
+        for (std::size_t i = 0; i < n; i++) {
+            p.xs.emplace_back(center.x + offset(gen));
+            p.ys.emplace_back(center.y + offset(gen));
+        }
+        return p;
+    }
+
+    float angle_difference(float a, float b) {
+        float d = std::fmod(std::abs(a - b), 360.0f);
+        return std::min(d, 360.0f - d);
+    }
+}
+
+TEST_CASE("Steering attraction kernels match scalar", "[steering]") {
+    auto isa = GENERATE(steering::Isa::SSE, steering::Isa::AVX2);
+    // nothing to compare on a cpu without it
+    if (!steering::supported(isa)) return;
+
+    std::mt19937 gen(42);
+    // odd sizes so the scalar tail runs too
+    auto n = GENERATE(1uz, 7uz, 64uz, 1003uz);
+    auto p = random_positions(gen, n, Vector2Zero(), ARENA_WIDTH / 2.0f);
+
+    std::uniform_real_distribution<float> coord(-ARENA_WIDTH / 2.0f, ARENA_WIDTH / 2.0f);
+    for (int t = 0; t < 10; t++) {
+        Vector2 target = {coord(gen), coord(gen)};
+
+        std::vector<float> ex(n), ey(n), eangle(n);
+        steering::attraction(target, p.xs, p.ys, ex, ey, eangle, steering::Isa::Scalar);
+
+        std::vector<float> x(n), y(n), angle(n);
+        steering::attraction(target, p.xs, p.ys, x, y, angle, isa);
+
+        for (std::size_t i = 0; i < n; i++) {
+            INFO("i = " << i);
+            REQUIRE(std::abs(x[i] - ex[i]) <= 1e-6f);
+            REQUIRE(std::abs(y[i] - ey[i]) <= 1e-6f);
+            REQUIRE(angle_difference(angle[i], eangle[i]) <= angle_tolerance);
+            REQUIRE(angle[i] >= 0.0f);
+            REQUIRE(angle[i] < 360.0f);
+        }
+    }
+}
+
+TEST_CASE("Steering attraction goes across the arena edge", "[steering]") {
+    auto isa = GENERATE(steering::Isa::Scalar, steering::Isa::SSE, steering::Isa::AVX2);
+    // nothing to compare on a cpu without it
+    if (!steering::supported(isa)) return;
+
+    // 8 lanes worth, all of them right next to the left edge with the target by the right one
+    std::vector<float> xs(8, -ARENA_WIDTH / 2.0f + 10.0f), ys(8, 0.0f);
+    std::vector<float> x(8), y(8), angle(8);
+    steering::attraction({ARENA_WIDTH / 2.0f - 10.0f, 0.0f}, xs, ys, x, y, angle, isa);
+
+    for (std::size_t i = 0; i < 8; i++) {
+        REQUIRE(x[i] == -1.0f);
+        REQUIRE(y[i] == 0.0f);
+    }
+}
+
+TEST_CASE("Steering separation kernels match scalar", "[steering]") {
+    auto isa = GENERATE(steering::Isa::SSE, steering::Isa::AVX2);
+    // nothing to compare on a cpu without it
+    if (!steering::supported(isa)) return;
+
+    std::mt19937 gen(42);
+    auto n = GENERATE(0uz, 3uz, 16uz, 61uz, 500uz);
+
+    for (int t = 0; t < 10; t++) {
+        Vector2 self = {0.0f, 0.0f};
+        auto p = random_positions(gen, n, self, steering::neighbourhood_radius);
+        // somebody standing right on top doesn't push
+        if (n > 2) {
+            p.xs[2] = self.x;
+            p.ys[2] = self.y;
+        }
+
+        auto expected = steering::separation(self, p.xs, p.ys, steering::Isa::Scalar);
+        auto got = steering::separation(self, p.xs, p.ys, isa);
+
+        // only the order of the additions differs, so the error is relative to the biggest pushes and not the sum
+        float pushes = 0.0f;
+        for (std::size_t i = 0; i < n; i++) {
+            float len = Vector2Length(Vector2Subtract(self, {p.xs[i], p.ys[i]}));
+            if (len > 0.0f) pushes += 1.0f / len;
+        }
+        auto tolerance = 1e-5f * std::max(1.0f, pushes);
+        REQUIRE(std::isfinite(got.x));
+        REQUIRE(std::isfinite(got.y));
+        REQUIRE(std::abs(got.x - expected.x) <= tolerance);
+        REQUIRE(std::abs(got.y - expected.y) <= tolerance);
+    }
+}